@@ -0,0 +1,219 @@
+// bench/bench.c
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+// Queries in flight; a result is read back BENCH_QUERY_LAG frames after
+// it was issued, by which time the GPU has long finished it.
+#define BENCH_QUERY_LAG 4
+
+static const char* seriesNames[BENCH_SERIES_COUNT] = { "frame", "cpu", "gpu", "swap" };
+static const char* counterNames[BENCH_COUNTER_COUNT] = {
+    "gl_issued", "gl_elided", "cull_tested", "cull_visible", "cull_ms",
+    "draws", "programs", "draw_calls"
+};
+
+static double* samples[BENCH_SERIES_COUNT];
+static int     counts[BENCH_SERIES_COUNT];
+static int     capacity, warmupFrames, useGpu;
+
+static struct {
+    double sum, max;
+    int    frames;
+} counters[BENCH_COUNTER_COUNT];
+
+static int    frame = -1;   // index of the frame being recorded
+static Uint64 frameStart, swapStart, lastEnd;
+
+static GLuint queries[BENCH_QUERY_LAG];
+static int    queryFrame[BENCH_QUERY_LAG];   // frame a query measures, -1 if idle
+
+static double ms_since(Uint64 start, Uint64 end) {
+    return (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static void record(BenchSeries series, int atFrame, double ms) {
+    int i = atFrame - warmupFrames;
+    if (i < 0 || i >= capacity) return;
+    samples[series][counts[series]++] = ms;
+}
+
+static void collect_query(int slot) {
+    if (queryFrame[slot] < 0) return;
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &ns);
+    record(BENCH_GPU, queryFrame[slot], (double)ns / 1.0e6);
+    queryFrame[slot] = -1;
+}
+
+int bench_init(int frames, int warmup, int gpuTimers) {
+    capacity = frames;
+    warmupFrames = warmup;
+    useGpu = gpuTimers;
+    frame = -1;
+    lastEnd = 0;
+    memset(counters, 0, sizeof(counters));
+    for (int s = 0; s < BENCH_SERIES_COUNT; s++) {
+        samples[s] = malloc(sizeof(double) * frames);
+        counts[s] = 0;
+        if (!samples[s]) {
+            fprintf(stderr, "bench: cannot allocate %d samples\n", frames);
+            bench_destroy();
+            return -1;
+        }
+    }
+    if (useGpu) {
+        glGenQueries(BENCH_QUERY_LAG, queries);
+        for (int i = 0; i < BENCH_QUERY_LAG; i++) queryFrame[i] = -1;
+    }
+    return 0;
+}
+
+void bench_destroy(void) {
+    for (int s = 0; s < BENCH_SERIES_COUNT; s++) {
+        free(samples[s]);
+        samples[s] = NULL;
+    }
+    if (useGpu) {
+        glDeleteQueries(BENCH_QUERY_LAG, queries);
+        useGpu = 0;
+    }
+}
+
+void bench_begin_frame(void) {
+    frame++;
+    if (useGpu) {
+        int slot = frame % BENCH_QUERY_LAG;
+        collect_query(slot);
+        glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+        queryFrame[slot] = frame;
+    }
+    frameStart = SDL_GetPerformanceCounter();
+}
+
+void bench_before_swap(void) {
+    swapStart = SDL_GetPerformanceCounter();
+    record(BENCH_CPU, frame, ms_since(frameStart, swapStart));
+    if (useGpu) glEndQuery(GL_TIME_ELAPSED);
+}
+
+void bench_end_frame(void) {
+    Uint64 end = SDL_GetPerformanceCounter();
+    record(BENCH_SWAP, frame, ms_since(swapStart, end));
+    record(BENCH_FRAME, frame, ms_since(lastEnd ? lastEnd : frameStart, end));
+    lastEnd = end;
+}
+
+void bench_count(BenchCounter counter, double value) {
+    int i = frame - warmupFrames;
+    if (i < 0 || i >= capacity) return;
+    if (value > counters[counter].max) counters[counter].max = value;
+    counters[counter].sum += value;
+    counters[counter].frames++;
+}
+
+static double counter_mean(BenchCounter counter) {
+    int n = counters[counter].frames;
+    return n ? counters[counter].sum / n : 0.0;
+}
+
+// ---- report -----------------------------------------------------------------
+
+typedef struct {
+    double min, p50, p95, p99, max, mean;
+} Summary;
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentiles; sorts the series in place.
+static Summary summarize(double* values, int n) {
+    Summary s = {0};
+    if (n == 0) return s;
+    qsort(values, n, sizeof(double), compare_double);
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += values[i];
+    s.min  = values[0];
+    s.p50  = values[(n - 1) * 50 / 100];
+    s.p95  = values[(n - 1) * 95 / 100];
+    s.p99  = values[(n - 1) * 99 / 100];
+    s.max  = values[n - 1];
+    s.mean = sum / n;
+    return s;
+}
+
+static void json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; s && *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+int bench_report(const char* path, char scene, const char* backend, int width, int height) {
+    if (useGpu) {
+        for (int i = 0; i < BENCH_QUERY_LAG; i++) collect_query(i);
+    }
+
+    Summary sums[BENCH_SERIES_COUNT];
+    printf("bench: scene %c, %s, %dx%d, %d frames (+%d warm-up)\n",
+           scene, backend, width, height, counts[BENCH_FRAME], warmupFrames);
+    printf("bench: %-6s %9s %9s %9s %9s %9s\n", "ms", "min", "p50", "p95", "p99", "max");
+    for (int s = 0; s < BENCH_SERIES_COUNT; s++) {
+        sums[s] = summarize(samples[s], counts[s]);
+        if (counts[s] == 0) {
+            printf("bench: %-6s %9s\n", seriesNames[s], "n/a");
+            continue;
+        }
+        printf("bench: %-6s %9.3f %9.3f %9.3f %9.3f %9.3f\n", seriesNames[s],
+               sums[s].min, sums[s].p50, sums[s].p95, sums[s].p99, sums[s].max);
+    }
+    for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+        if (counters[c].frames == 0) continue;
+        printf("bench: %-12s mean %10.3f  max %10.3f per frame\n", counterNames[c],
+               counter_mean(c), counters[c].max);
+    }
+    if (!path) return 0;
+
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "bench: cannot write %s\n", path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"scene\": \"%c\",\n  \"backend\": ", scene);
+    json_string(f, backend);
+    fprintf(f, ",\n  \"renderer\": ");
+    json_string(f, useGpu ? (const char*)glGetString(GL_RENDERER) : "software");
+    fprintf(f, ",\n  \"version\": ");
+    json_string(f, useGpu ? (const char*)glGetString(GL_VERSION) : "");
+    fprintf(f, ",\n  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n  \"warmup\": %d",
+            width, height, counts[BENCH_FRAME], warmupFrames);
+    for (int s = 0; s < BENCH_SERIES_COUNT; s++) {
+        fprintf(f, ",\n  \"%s_ms\": ", seriesNames[s]);
+        if (counts[s] == 0) {
+            fprintf(f, "null");
+            continue;
+        }
+        fprintf(f, "{ \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, "
+                   "\"max\": %.4f, \"mean\": %.4f }",
+                sums[s].min, sums[s].p50, sums[s].p95, sums[s].p99, sums[s].max, sums[s].mean);
+    }
+    for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+        fprintf(f, ",\n  \"%s\": ", counterNames[c]);
+        if (counters[c].frames == 0) {
+            fprintf(f, "null");
+            continue;
+        }
+        fprintf(f, "{ \"mean\": %.4f, \"max\": %.4f }", counter_mean(c), counters[c].max);
+    }
+    fprintf(f, "\n}\n");
+    fclose(f);
+    printf("bench: report written to %s\n", path);
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// ------------------------------------------------------------------
+// Frame benchmark (bench/bench.c):
+// records, for every frame after a warm-up, the wall time between
+// frames, the CPU time spent building and submitting it, the GPU time
+// of its commands (GL_TIME_ELAPSED queries read back a few frames
+// late so they never stall) and the time spent in the swap (glFinish
+// when headless). bench_report() prints min/p50/p95/p99/max of each
+// series and writes them as JSON, along with the mean and max of the
+// renderer's per-frame counters.
+// ------------------------------------------------------------------
+
+typedef enum {
+    BENCH_FRAME,   // start of one frame to start of the next
+    BENCH_CPU,     // frame start to bench_before_swap()
+    BENCH_GPU,
+    BENCH_SWAP,    // bench_before_swap() to bench_end_frame()
+    BENCH_SERIES_COUNT
+} BenchSeries;
+
+typedef enum {
+    BENCH_GL_ISSUED,   // GL calls the state cache passed on
+    BENCH_GL_ELIDED,   // ... and dropped as redundant
+    BENCH_CULL_TESTED, // bounding volumes tested against the frustum
+    BENCH_CULL_VISIBLE,
+    BENCH_CULL_MS,     // CPU time culling, summed over threads
+    BENCH_DRAWS,       // draws queued with batch_add()
+    BENCH_PROGRAMS,    // distinct pipeline states among them
+    BENCH_DRAW_CALLS,  // GL draw calls batch_flush() issued for them
+    BENCH_COUNTER_COUNT
+} BenchCounter;
+
+// `gpuTimers` is 0 when there is no GL context (software rasterizer).
+int  bench_init(int frames, int warmup, int gpuTimers);
+void bench_destroy(void);
+
+void bench_begin_frame(void);
+void bench_before_swap(void);
+void bench_end_frame(void);
+// Once per counter and frame, after bench_end_frame(); warm-up frames
+// are not counted.
+void bench_count(BenchCounter counter, double value);
+
+// `scene` and `backend` label the report; `path` may be NULL.
+int  bench_report(const char* path, char scene, const char* backend, int width, int height);
+
+#endif // BENCH_H
@@ -0,0 +1,112 @@
+// bench/kernels.c
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "kernels.h"
+#include "../render/transform.h"
+
+#define RUNS 21
+
+static int compare_ns(const void* a, const void* b) {
+    double d = *(const double*)a - *(const double*)b;
+    return (d > 0) - (d < 0);
+}
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+}
+
+static float random_unit(void) {
+    return (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+// The per-object path the shapes used before batching
+static void build_cglm(const TransformSet* s, int count, mat4 parent, mat4* out) {
+    for (int o = 0; o < count; o++) {
+        mat4 m;
+        versor q = { s->qx[o], s->qy[o], s->qz[o], s->qw[o] };
+        glm_translate_make(m, (vec3){ s->px[o], s->py[o], s->pz[o] });
+        glm_quat_rotate(m, q, m);
+        glm_scale(m, (vec3){ s->sx[o], s->sy[o], s->sz[o] });
+        if (parent) glm_mat4_mul(parent, m, out[o]);
+        else        glm_mat4_copy(m, out[o]);
+    }
+}
+
+static void build_batch(const TransformSet* s, int count, mat4 parent, mat4* out) {
+    transform_build(s, 0, count, parent, out);
+}
+
+// Median ns per object over RUNS builds
+static double time_build(void (*fn)(const TransformSet*, int, mat4, mat4*),
+                         const TransformSet* s, int count, mat4 parent, mat4* out) {
+    double ns[RUNS];
+    fn(s, count, parent, out);   // warm up
+    for (int r = 0; r < RUNS; r++) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        fn(s, count, parent, out);
+        ns[r] = seconds_since(start) * 1.0e9 / count;
+    }
+    qsort(ns, RUNS, sizeof(double), compare_ns);
+    return ns[RUNS / 2];
+}
+
+static float max_difference(const mat4* a, const mat4* b, int count) {
+    float worst = 0.0f;
+    for (int o = 0; o < count; o++) {
+        for (int e = 0; e < 16; e++) {
+            float d = fabsf(a[o][e / 4][e % 4] - b[o][e / 4][e % 4]);
+            if (d > worst) worst = d;
+        }
+    }
+    return worst;
+}
+
+static int random_set(TransformSet* set, int count) {
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        vec3 position = { random_unit() * 50.0f, random_unit() * 5.0f, random_unit() * 50.0f - 60.0f };
+        versor rotation = { random_unit(), random_unit(), random_unit(), random_unit() };
+        glm_quat_normalize(rotation);
+        vec3 scale = { 0.5f + random_unit() * 0.25f, 1.0f, 0.5f + random_unit() * 0.25f };
+        if (transform_set_add(set, position, rotation, scale) < 0) return -1;
+    }
+    return 0;
+}
+
+int bench_transform_kernel(int count) {
+    if (count <= 0) count = 100000;
+    TransformSet set;
+    transform_set_init(&set);
+    mat4* reference = aligned_alloc(32, sizeof(mat4) * count);
+    mat4* batched   = aligned_alloc(32, sizeof(mat4) * count);
+    if (!reference || !batched || random_set(&set, count) != 0) {
+        fprintf(stderr, "transform bench: cannot allocate %d objects\n", count);
+        transform_set_free(&set);
+        free(reference);
+        free(batched);
+        return -1;
+    }
+    mat4 view, proj, viewProj;
+    glm_perspective(glm_rad(45.0f), 16.0f / 9.0f, 0.1f, 200.0f, proj);
+    glm_lookat((vec3){ 0.0f, 10.0f, 5.0f }, (vec3){ 0.0f, 0.0f, -60.0f },
+               (vec3){ 0.0f, 1.0f, 0.0f }, view);
+    glm_mat4_mul(proj, view, viewProj);
+
+    printf("transform bench: %d objects, %s kernel\n", count, transform_kernel_name());
+    printf("           cglm ns/obj   batch ns/obj   speedup   max diff\n");
+    for (int mvp = 0; mvp < 2; mvp++) {
+        vec4* parent = mvp ? viewProj : NULL;
+        double perObject = time_build(build_cglm, &set, count, parent, reference);
+        double batch = time_build(build_batch, &set, count, parent, batched);
+        printf("  %-6s   %11.2f   %12.2f   %6.2fx   %8.2g\n", mvp ? "mvp" : "model",
+               perObject, batch, perObject / batch, max_difference(reference, batched, count));
+    }
+
+    transform_set_free(&set);
+    free(reference);
+    free(batched);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef BENCH_KERNELS_H
+#define BENCH_KERNELS_H
+
+// ------------------------------------------------------------------
+// Transform kernel microbenchmark (bench/kernels.c):
+// builds `count` (<= 0: 100000) model and MVP matrices from random
+// positions, rotations and scales, once per object with cglm
+// (translate, quaternion rotate, scale, multiply) and once with
+// transform_build(), and prints the median ns per object of each, the
+// speedup and the largest difference between their results.
+// ------------------------------------------------------------------
+
+int bench_transform_kernel(int count);
+
+#endif // BENCH_KERNELS_H
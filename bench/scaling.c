@@ -0,0 +1,124 @@
+// bench/scaling.c
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "scaling.h"
+#include "../core/jobs.h"
+#include "../render/cull.h"
+
+#define OBJECTS 1048576
+#define CHUNK   1024      // a multiple of CULL_GROUP
+#define RUNS    15
+
+typedef struct {
+    CullSet bounds;
+    float*  phase;
+    int*    visible;
+    int*    chunkVisible;
+    mat4*   models;
+    vec4    planes[6];
+} Workload;
+
+static void update_chunks(void* data, int begin, int end) {
+    Workload* w = data;
+    for (int c = begin; c < end; c++) {
+        int first = c * CHUNK;
+        int* idx = w->visible + first;
+        int n = cull_run_range(&w->bounds, w->planes, first, CHUNK, idx);
+        for (int i = 0; i < n; i++) {
+            int o = idx[i];
+            mat4 m = GLM_MAT4_IDENTITY_INIT;
+            glm_translate(m, (vec3){ w->bounds.x[o], w->bounds.y[o], w->bounds.z[o] });
+            glm_rotate(m, w->phase[o], (vec3){ 0, 1, 0 });
+            glm_scale(m, (vec3){ 0.15f, 0.15f, 0.15f });
+            glm_mat4_copy(m, w->models[first + i]);
+        }
+        w->chunkVisible[c] = n;
+    }
+}
+
+static int compare_ms(const void* a, const void* b) {
+    double d = *(const double*)a - *(const double*)b;
+    return (d > 0) - (d < 0);
+}
+
+// Median of RUNS updates, in ms
+static double time_update(Workload* w) {
+    double ms[RUNS];
+    update_chunks(w, 0, 1);   // warm the caches and the workers
+    for (int r = 0; r < RUNS; r++) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        jobs_parallel_for(update_chunks, w, OBJECTS / CHUNK, 1);
+        ms[r] = (double)(SDL_GetPerformanceCounter() - start) * 1000.0
+              / (double)SDL_GetPerformanceFrequency();
+    }
+    qsort(ms, RUNS, sizeof(double), compare_ms);
+    return ms[RUNS / 2];
+}
+
+static int workload_init(Workload* w) {
+    cull_set_init(&w->bounds, CULL_SPHERES);
+    w->phase        = malloc(sizeof(float) * OBJECTS);
+    w->visible      = malloc(sizeof(int) * OBJECTS);
+    w->chunkVisible = malloc(sizeof(int) * (OBJECTS / CHUNK));
+    w->models       = malloc(sizeof(mat4) * OBJECTS);
+    if (!w->phase || !w->visible || !w->chunkVisible || !w->models) return -1;
+
+    // A 1024 x 1024 grid in front of a 45° camera; about half of it is
+    // in view, so both the culling and the matrix work count
+    srand(1);
+    for (int i = 0; i < OBJECTS; i++) {
+        vec3 c = { (float)(i % 1024) - 512.0f, 0.0f, -(float)(i / 1024) - 1.0f };
+        if (cull_set_add_sphere(&w->bounds, c, 0.26f) < 0) return -1;
+        w->phase[i] = (float)rand() / (float)RAND_MAX * 6.2831853f;
+    }
+    mat4 proj, view, viewProj;
+    glm_perspective(glm_rad(45.0f), 16.0f / 9.0f, 0.1f, 2000.0f, proj);
+    glm_lookat((vec3){ 0.0f, 40.0f, 0.0f }, (vec3){ 0.0f, 0.0f, -400.0f },
+               (vec3){ 0.0f, 1.0f, 0.0f }, view);
+    glm_mat4_mul(proj, view, viewProj);
+    glm_frustum_planes(viewProj, w->planes);
+    return 0;
+}
+
+static void workload_free(Workload* w) {
+    cull_set_free(&w->bounds);
+    free(w->phase);
+    free(w->visible);
+    free(w->chunkVisible);
+    free(w->models);
+}
+
+int bench_jobs_scaling(int maxThreads) {
+    if (maxThreads <= 0) maxThreads = SDL_GetCPUCount();
+    if (maxThreads > JOBS_MAX_THREADS) maxThreads = JOBS_MAX_THREADS;
+
+    Workload w = { 0 };
+    if (workload_init(&w) != 0) {
+        fprintf(stderr, "jobs bench: cannot allocate %d objects\n", OBJECTS);
+        workload_free(&w);
+        return -1;
+    }
+
+    printf("jobs bench: %d objects in %d chunks, %d cores, %s culling\n",
+           OBJECTS, OBJECTS / CHUNK, SDL_GetCPUCount(), cull_kernel_name());
+    printf("  threads   median ms   speedup   efficiency\n");
+    double base = 0.0;
+    for (int t = 1; t <= maxThreads; t++) {
+        // 1, 2, 4, 8... and the top count itself
+        if (t > 2 && t != maxThreads && (t & (t - 1)) != 0) continue;
+        if (jobs_init(t) != 0) break;
+        double ms = time_update(&w);
+        if (t == 1) base = ms;
+        printf("  %7d   %9.2f   %6.2fx   %9.0f%%\n",
+               jobs_thread_count(), ms, base / ms, 100.0 * base / ms / jobs_thread_count());
+    }
+    jobs_destroy();
+
+    int survivors = 0;
+    for (int c = 0; c < OBJECTS / CHUNK; c++) survivors += w.chunkVisible[c];
+    printf("  %d of %d objects visible\n", survivors, OBJECTS);
+    workload_free(&w);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef BENCH_SCALING_H
+#define BENCH_SCALING_H
+
+// ------------------------------------------------------------------
+// Job system scaling benchmark (bench/scaling.c):
+// culls a million bounding spheres and builds a model matrix for each
+// survivor with jobs_parallel_for(), the same way the field scene
+// updates itself, once per thread count from 1 to `maxThreads` (<= 0:
+// one per core), and prints the median time, speedup and parallel
+// efficiency of each. Leaves the job system shut down.
+// ------------------------------------------------------------------
+
+int bench_jobs_scaling(int maxThreads);
+
+#endif // BENCH_SCALING_H
@@ -0,0 +1,230 @@
+// bench/trace.c
+#include <SDL2/SDL.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+// -----------------------------------------------------------------------------
+// Each ring has one writer (its thread) and one reader (the flush thread):
+// the writer publishes with a release store of `head`, the reader frees slots
+// with a release store of `tail`, and neither ever waits for the other. The
+// counters run freely and are masked on access, so head - tail is the fill.
+// SDL's atomics are full barriers; C11 atomics let the hot path use plain
+// loads and a single release store instead.
+// -----------------------------------------------------------------------------
+
+#define RING_MASK (TRACE_RING - 1)
+#define FLUSH_INTERVAL_MS 100
+
+typedef struct {
+    const char* name;
+    Uint64 start, end;
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    TraceEvent events[TRACE_RING];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_uint dropped;
+    unsigned cachedTail;   // writer's last view of tail
+    int tid;
+    const char* name;
+    int nameWritten;
+    struct TraceBuffer* next;
+} TraceBuffer;
+
+static atomic_int enabled = 0;
+// Bumped when trace_stop() frees the rings, so threads drop their pointer
+static atomic_uint generation = 0;
+static _Thread_local TraceBuffer* local = NULL;
+static _Thread_local unsigned localGeneration;
+static _Thread_local const char* localName = NULL;
+
+static SDL_mutex* registry = NULL;   // guards `buffers` and names
+static TraceBuffer* buffers = NULL;
+static int nextTid = 1;
+
+static FILE* file = NULL;
+static int firstEvent = 1;
+static Uint64 origin;
+static double ticksPerUs;
+static SDL_Thread* flusher = NULL;
+static SDL_sem* stopSem = NULL;
+
+// ---- recording --------------------------------------------------------------
+
+static TraceBuffer* local_buffer(void) {
+    unsigned current = atomic_load_explicit(&generation, memory_order_acquire);
+    if (local && localGeneration == current) return local;
+    local = NULL;
+    TraceBuffer* b = calloc(1, sizeof(TraceBuffer));
+    if (!b) return NULL;
+    SDL_LockMutex(registry);
+    b->tid = nextTid++;
+    b->name = localName;
+    b->next = buffers;
+    buffers = b;
+    SDL_UnlockMutex(registry);
+    local = b;
+    localGeneration = current;
+    return b;
+}
+
+TraceZone trace_zone_begin(const char* name) {
+    TraceZone zone = { name, 0 };
+    if (atomic_load_explicit(&enabled, memory_order_relaxed)) {
+        zone.start = SDL_GetPerformanceCounter();
+    }
+    return zone;
+}
+
+void trace_zone_end(TraceZone* zone) {
+    if (zone->start == 0) return;
+    Uint64 end = SDL_GetPerformanceCounter();
+    TraceBuffer* b = local_buffer();
+    if (!b) return;
+
+    unsigned head = atomic_load_explicit(&b->head, memory_order_relaxed);
+    if (head - b->cachedTail >= TRACE_RING) {
+        // Only look at the reader's line when the ring seems full
+        b->cachedTail = atomic_load_explicit(&b->tail, memory_order_acquire);
+        if (head - b->cachedTail >= TRACE_RING) {
+            atomic_fetch_add_explicit(&b->dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+    b->events[head & RING_MASK] = (TraceEvent){ zone->name, zone->start, end };
+    atomic_store_explicit(&b->head, head + 1, memory_order_release);
+}
+
+void trace_thread_name(const char* name) {
+    localName = name;   // also names the rings of later sessions
+    if (!registry) return;
+    TraceBuffer* b = local_buffer();
+    if (!b) return;
+    SDL_LockMutex(registry);
+    b->name = name;
+    b->nameWritten = 0;
+    SDL_UnlockMutex(registry);
+}
+
+void trace_set_enabled(int on) {
+    atomic_store_explicit(&enabled, on && file != NULL, memory_order_relaxed);
+}
+
+int trace_enabled(void) {
+    return atomic_load_explicit(&enabled, memory_order_relaxed);
+}
+
+// ---- output -----------------------------------------------------------------
+
+static double to_us(Uint64 ticks) {
+    return (double)(ticks - origin) / ticksPerUs;
+}
+
+static void separator(void) {
+    if (!firstEvent) fputs(",\n", file);
+    firstEvent = 0;
+}
+
+static void json_string(const char* s) {
+    fputc('"', file);
+    for (; s && *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', file);
+        if ((unsigned char)*s >= 0x20) fputc(*s, file);
+    }
+    fputc('"', file);
+}
+
+static void drain(void) {
+    SDL_LockMutex(registry);
+    for (TraceBuffer* b = buffers; b; b = b->next) {
+        if (b->name && !b->nameWritten) {
+            separator();
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                          "\"args\":{\"name\":", b->tid);
+            json_string(b->name);
+            fputs("}}", file);
+            b->nameWritten = 1;
+        }
+        unsigned head = atomic_load_explicit(&b->head, memory_order_acquire);
+        unsigned tail = atomic_load_explicit(&b->tail, memory_order_relaxed);
+        for (; tail != head; tail++) {
+            const TraceEvent* e = &b->events[tail & RING_MASK];
+            separator();
+            fputs("{\"name\":", file);
+            json_string(e->name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    b->tid, to_us(e->start), to_us(e->end) - to_us(e->start));
+        }
+        atomic_store_explicit(&b->tail, tail, memory_order_release);
+    }
+    SDL_UnlockMutex(registry);
+}
+
+static int flush_main(void* arg) {
+    (void)arg;
+    // Wakes every FLUSH_INTERVAL_MS until trace_stop() posts the semaphore
+    while (SDL_SemWaitTimeout(stopSem, FLUSH_INTERVAL_MS) == SDL_MUTEX_TIMEDOUT) {
+        drain();
+    }
+    return 0;
+}
+
+int trace_start(const char* path) {
+    if (file) return 0;
+    if (!registry) registry = SDL_CreateMutex();
+    stopSem = SDL_CreateSemaphore(0);
+    file = fopen(path, "w");
+    if (!registry || !stopSem || !file) {
+        fprintf(stderr, "trace: cannot start a trace in %s\n", path);
+        if (file) fclose(file);
+        file = NULL;
+        return -1;
+    }
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    firstEvent = 1;
+    origin = SDL_GetPerformanceCounter();
+    ticksPerUs = (double)SDL_GetPerformanceFrequency() / 1.0e6;
+
+    trace_thread_name("main");
+    flusher = SDL_CreateThread(flush_main, "trace", NULL);
+    if (!flusher) {
+        fprintf(stderr, "trace: cannot create the flush thread: %s\n", SDL_GetError());
+    }
+    trace_set_enabled(1);
+    printf("trace: recording to %s\n", path);
+    return 0;
+}
+
+void trace_stop(void) {
+    if (!file) return;
+    trace_set_enabled(0);
+    if (flusher) {
+        SDL_SemPost(stopSem);
+        SDL_WaitThread(flusher, NULL);
+        flusher = NULL;
+    }
+    drain();
+    fputs("\n]}\n", file);
+    fclose(file);
+    file = NULL;
+    SDL_DestroySemaphore(stopSem);
+    stopSem = NULL;
+
+    // Every ring is drained: free them all, including those of threads
+    // that have exited. A thread that records again gets a new one.
+    unsigned dropped = 0;
+    SDL_LockMutex(registry);
+    while (buffers) {
+        TraceBuffer* next = buffers->next;
+        dropped += atomic_load_explicit(&buffers->dropped, memory_order_relaxed);
+        free(buffers);
+        buffers = next;
+    }
+    atomic_fetch_add_explicit(&generation, 1, memory_order_release);
+    SDL_UnlockMutex(registry);
+    if (dropped) fprintf(stderr, "trace: %u zones dropped, rings were full\n", dropped);
+}
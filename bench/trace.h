@@ -0,0 +1,45 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <SDL2/SDL.h>
+
+// ------------------------------------------------------------------
+// CPU trace zones (bench/trace.c):
+// a zone records its name and its start and end ticks into a ring
+// owned by the calling thread, so recording takes no lock and
+// touches no shared cache line. A background thread drains every
+// ring into a Chrome trace-event JSON file ("X" events, microsecond
+// timestamps with nanosecond decimals) that chrome://tracing and
+// Perfetto open directly. A full ring drops zones rather than block.
+//
+// Zones are only recorded between trace_start() and trace_stop()
+// while trace_enabled(); otherwise a zone costs one relaxed load.
+// Names must outlive the session (string literals).
+// ------------------------------------------------------------------
+#define TRACE_RING 16384   // zones per thread between two drains
+
+typedef struct {
+    const char* name;
+    Uint64      start;   // 0 if not recording
+} TraceZone;
+
+int  trace_start(const char* path);
+// Call when no other thread is inside a zone (workers idle or stopped).
+void trace_stop(void);
+void trace_set_enabled(int enabled);
+int  trace_enabled(void);
+
+// Names the calling thread in the trace.
+void trace_thread_name(const char* name);
+
+TraceZone trace_zone_begin(const char* name);
+void      trace_zone_end(TraceZone* zone);
+
+// Records the rest of the enclosing block as one zone (GCC/Clang cleanup).
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(name) \
+    TraceZone TRACE_CONCAT(traceZone, __LINE__) \
+        __attribute__((cleanup(trace_zone_end))) = trace_zone_begin(name)
+
+#endif // TRACE_H
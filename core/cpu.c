@@ -0,0 +1,67 @@
+// core/cpu.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+
+// Widest level this build has kernels for
+#if CPU_TARGET_PRAGMAS
+#define CPU_COMPILED CPU_AVX512
+#elif defined(__SSE2__)
+#define CPU_COMPILED CPU_SSE
+#else
+#define CPU_COMPILED CPU_SCALAR
+#endif
+
+static const char* names[CPU_LEVEL_COUNT] = { "scalar", "sse", "avx2", "avx512" };
+
+static CpuLevel level = CPU_SCALAR;
+static CpuLevel detected = CPU_SCALAR;
+
+// What the CPU and the OS support: GCC's checks include the XGETBV test
+// that the OS saves the AVX / AVX-512 registers.
+static CpuLevel detect(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return CPU_AVX512;
+    if (__builtin_cpu_supports("avx2"))    return CPU_AVX2;
+    if (__builtin_cpu_supports("sse2"))    return CPU_SSE;
+#endif
+    return CPU_SCALAR;
+}
+
+void cpu_init(void) {
+    detected = detect();
+    level = detected < CPU_COMPILED ? detected : CPU_COMPILED;
+
+    int forced = 0;
+    const char* wanted = getenv("GRAPHICS_SIMD");
+    if (wanted && *wanted) {
+        int i = 0;
+        while (i < CPU_LEVEL_COUNT && strcmp(wanted, names[i]) != 0) i++;
+        if (i == CPU_LEVEL_COUNT) {
+            fprintf(stderr, "cpu: unknown GRAPHICS_SIMD=%s (scalar, sse, avx2, avx512)\n", wanted);
+        } else if ((CpuLevel)i > level) {
+            // Running it would fault on the first instruction it lacks
+            fprintf(stderr, "cpu: GRAPHICS_SIMD=%s is not available here\n", wanted);
+        } else {
+            level = (CpuLevel)i;
+            forced = 1;
+        }
+    }
+
+    printf("cpu: %s kernels (detected %s%s)\n", names[level], names[detected],
+           forced ? ", set by GRAPHICS_SIMD" : "");
+}
+
+CpuLevel cpu_level(void) {
+    return level;
+}
+
+CpuLevel cpu_detected(void) {
+    return detected;
+}
+
+const char* cpu_level_name(CpuLevel l) {
+    return l >= 0 && l < CPU_LEVEL_COUNT ? names[l] : "?";
+}
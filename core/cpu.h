@@ -0,0 +1,42 @@
+#ifndef CORE_CPU_H
+#define CORE_CPU_H
+
+// ------------------------------------------------------------------
+// CPU dispatch (core/cpu.c):
+// the hot kernels (culling, transforms, the rasterizer's blocks) are
+// compiled once per instruction set in the same binary, and each call
+// goes to the widest one this CPU and OS support. cpu_init() picks
+// that level once at startup and logs it; GRAPHICS_SIMD=scalar|sse|
+// avx2|avx512 forces a lower one, so every path can be benchmarked on
+// one machine.
+//
+// Levels above SSE are built with GCC's target pragmas on x86
+// (CPU_TARGET_PRAGMAS); other compilers and CPUs get scalar and, where
+// the compiler targets it, SSE.
+// ------------------------------------------------------------------
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_TARGET_PRAGMAS 1
+#else
+#define CPU_TARGET_PRAGMAS 0
+#endif
+
+// Ordered: each level includes the ones below it
+typedef enum {
+    CPU_SCALAR,
+    CPU_SSE,      // SSE2
+    CPU_AVX2,
+    CPU_AVX512,   // AVX-512F
+    CPU_LEVEL_COUNT
+} CpuLevel;
+
+// Detects the CPU, applies GRAPHICS_SIMD and logs the result. Call once
+// at startup, before any other thread runs a kernel.
+void cpu_init(void);
+
+// The level kernels dispatch on (scalar before cpu_init())
+CpuLevel    cpu_level(void);
+// The widest level this machine supports, whatever GRAPHICS_SIMD says
+CpuLevel    cpu_detected(void);
+const char* cpu_level_name(CpuLevel level);
+
+#endif // CORE_CPU_H
@@ -0,0 +1,191 @@
+// core/frame.c
+#define _GNU_SOURCE   // dladdr
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "frame.h"
+#include "jobs.h"
+
+static LinearArena frames[2];
+static int current = 0;
+static LinearArena scratch[JOBS_MAX_THREADS];
+static int scratchCount = 0;
+// Outside the pool: no block, everything is heap until released
+static _Thread_local LinearArena foreign;
+static unsigned frameCount = 0;
+
+// ---- allocation counting ----------------------------------------------------
+
+#ifdef FRAME_MEMORY_DEBUG
+#include <dlfcn.h>
+#include <errno.h>
+
+#define MAX_FLAGGED 10   // frames reported one by one
+
+// glibc's own entry points, which the wrappers below forward to
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* p, size_t size);
+extern void* __libc_memalign(size_t align, size_t size);
+// The program's code, as laid out by the default linker script
+extern char __executable_start[], etext[];
+
+static atomic_int counting;
+static atomic_uint ours, theirs;          // this frame
+static void* _Atomic firstCaller;         // of this frame's first in `ours`
+static unsigned long oursTotal = 0, theirsTotal = 0;
+static unsigned flaggedFrames = 0;
+
+static void count(void* caller) {
+    if (!atomic_load_explicit(&counting, memory_order_relaxed)) return;
+    if ((char*)caller >= __executable_start && (char*)caller < etext) {
+        if (atomic_fetch_add_explicit(&ours, 1, memory_order_relaxed) == 0) {
+            atomic_store_explicit(&firstCaller, caller, memory_order_relaxed);
+        }
+    } else {
+        atomic_fetch_add_explicit(&theirs, 1, memory_order_relaxed);
+    }
+}
+
+void* malloc(size_t size) {
+    count(__builtin_return_address(0));
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    count(__builtin_return_address(0));
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t size) {
+    count(__builtin_return_address(0));
+    return __libc_realloc(p, size);
+}
+
+void* aligned_alloc(size_t align, size_t size) {
+    count(__builtin_return_address(0));
+    return __libc_memalign(align, size);
+}
+
+void* memalign(size_t align, size_t size) {
+    count(__builtin_return_address(0));
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void** out, size_t align, size_t size) {
+    count(__builtin_return_address(0));
+    if (align % sizeof(void*) != 0 || (align & (align - 1)) != 0) return EINVAL;
+    void* p = __libc_memalign(align, size);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+static void flag_frame(unsigned allocations) {
+    void* caller = atomic_load_explicit(&firstCaller, memory_order_relaxed);
+    Dl_info info;
+    fprintf(stderr, "frame memory: frame %u made %u heap allocations, first from ",
+            frameCount, allocations);
+    // Names need the program's symbols exported (-rdynamic)
+    if (dladdr(caller, &info) && info.dli_sname) {
+        fprintf(stderr, "%s+0x%lx\n", info.dli_sname,
+                (unsigned long)((char*)caller - (char*)info.dli_saddr));
+    } else {
+        fprintf(stderr, "%p\n", caller);
+    }
+    if (++flaggedFrames == MAX_FLAGGED) {
+        fprintf(stderr, "frame memory: not flagging further frames\n");
+    }
+}
+#endif
+
+// ---- arenas -----------------------------------------------------------------
+
+int frame_memory_init(size_t frameBytes, size_t scratchBytes) {
+    frame_memory_destroy();
+    int failed = 0;
+    for (int i = 0; i < 2; i++) failed |= linear_init(&frames[i], frameBytes) != 0;
+    scratchCount = jobs_thread_count();
+    for (int i = 0; i < scratchCount; i++) {
+        failed |= linear_init(&scratch[i], scratchBytes) != 0;
+    }
+    if (failed) {
+        fprintf(stderr, "frame memory: cannot allocate the arenas\n");
+        frame_memory_destroy();
+        return -1;
+    }
+    return 0;
+}
+
+void frame_memory_destroy(void) {
+    for (int i = 0; i < 2; i++) linear_free(&frames[i]);
+    for (int i = 0; i < scratchCount; i++) linear_free(&scratch[i]);
+    scratchCount = 0;
+    current = 0;
+    frameCount = 0;
+}
+
+void frame_memory_begin(void) {
+    // Nothing from two frames ago is referenced any more; growing here
+    // keeps the allocation out of the frame
+    current ^= 1;
+    if (linear_reset(&frames[current]) != 0) {
+        fprintf(stderr, "frame memory: cannot grow the frame arena\n");
+    }
+    // No job runs between frames, so every scratch arena is empty
+    for (int i = 0; i < scratchCount; i++) {
+        if (linear_reset(&scratch[i]) != 0) {
+            fprintf(stderr, "frame memory: cannot grow scratch arena %d\n", i);
+        }
+    }
+    frameCount++;
+
+#ifdef FRAME_MEMORY_DEBUG
+    atomic_store(&ours, 0);
+    atomic_store(&theirs, 0);
+    atomic_store(&counting, 1);
+#endif
+}
+
+void frame_memory_end(void) {
+#ifdef FRAME_MEMORY_DEBUG
+    atomic_store(&counting, 0);
+    unsigned o = atomic_load(&ours), t = atomic_load(&theirs);
+    if (frameCount <= FRAME_MEMORY_SETTLE) return;
+    oursTotal += o;
+    theirsTotal += t;
+    if (o > 0 && flaggedFrames < MAX_FLAGGED) flag_frame(o);
+#endif
+}
+
+void* frame_alloc(size_t size) {
+    return linear_alloc(&frames[current], size);
+}
+
+LinearArena* frame_scratch(void) {
+    int index = jobs_thread_index();
+    return index >= 0 && index < scratchCount ? &scratch[index] : &foreign;
+}
+
+void frame_memory_report(FILE* out) {
+    size_t frameSize = 0, framePeak = 0, scratchSize = 0, scratchPeak = 0;
+    unsigned grows = 0;
+    for (int i = 0; i < 2; i++) {
+        if (frames[i].size > frameSize) frameSize = frames[i].size;
+        if (frames[i].peak > framePeak) framePeak = frames[i].peak;
+        grows += frames[i].grows;
+    }
+    for (int i = 0; i < scratchCount; i++) {
+        if (scratch[i].size > scratchSize) scratchSize = scratch[i].size;
+        if (scratch[i].peak > scratchPeak) scratchPeak = scratch[i].peak;
+        grows += scratch[i].grows;
+    }
+    fprintf(out, "frame memory: 2 x %.0f KiB frame arenas (peak %.0f KiB), "
+                 "%d x %.0f KiB scratch (peak %.0f KiB), grown %u times\n",
+            frameSize / 1024.0, framePeak / 1024.0,
+            scratchCount, scratchSize / 1024.0, scratchPeak / 1024.0, grows);
+#ifdef FRAME_MEMORY_DEBUG
+    fprintf(out, "frame memory: after frame %d, %lu heap allocations by this program, "
+                 "%lu by libraries\n", FRAME_MEMORY_SETTLE, oursTotal, theirsTotal);
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef CORE_FRAME_H
+#define CORE_FRAME_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "linear.h"
+
+// ------------------------------------------------------------------
+// Frame memory (core/frame.c):
+// transient per-frame arrays (visible lists, staging for uploads)
+// come from linear arenas instead of the heap, so a steady frame
+// allocates nothing.
+//
+// - Two frame arenas take turns: frame_memory_begin() switches to the
+//   other one and resets it, so what frame_alloc() returned stays
+//   valid until the end of the next frame.
+// - Every thread of the job pool (core/jobs.h) has a scratch arena
+//   for temporaries inside a job: take a linear_mark() of
+//   frame_scratch(), allocate, linear_release() before returning.
+//   Other threads get a heap-backed one that holds nothing between
+//   marks.
+// - Arenas that overflowed are grown at the next frame_memory_begin(),
+//   outside the frame, so after warm-up they stay within their blocks.
+//
+// Built with FRAME_MEMORY_DEBUG (make FRAME_DEBUG=1), the malloc
+// family is wrapped and every heap allocation made between
+// frame_memory_begin() and frame_memory_end() is counted, split into
+// this program's calls and the libraries' (driver, SDL); frames after
+// FRAME_MEMORY_SETTLE in which this program allocates are flagged on
+// stderr with the first caller.
+// ------------------------------------------------------------------
+#define FRAME_MEMORY_SETTLE 3   // frames allowed to fill grow-only arrays
+
+// Sizes are starting points; the arenas grow to what frames need.
+// Call after jobs_init().
+int   frame_memory_init(size_t frameBytes, size_t scratchBytes);
+void  frame_memory_destroy(void);
+
+// Bracket every frame that is drawn, on the thread that draws it.
+void  frame_memory_begin(void);
+void  frame_memory_end(void);
+
+// Main thread only: from this frame's arena (LINEAR_ALIGN-aligned),
+// valid until the end of the next frame.
+void* frame_alloc(size_t size);
+
+// The calling thread's scratch arena.
+LinearArena* frame_scratch(void);
+
+void  frame_memory_report(FILE* out);
+
+#endif // CORE_FRAME_H
@@ -0,0 +1,284 @@
+// core/jobs.c
+#define _GNU_SOURCE   // pthread_setaffinity_np
+#include <SDL2/SDL.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define cpu_relax() _mm_pause()
+#else
+#define cpu_relax() ((void)0)
+#endif
+#include "jobs.h"
+#include "../bench/trace.h"
+
+// Failed looks for work before a worker goes to sleep
+#define IDLE_SPINS 256
+
+typedef struct {
+    JobFn       fn;
+    void*       data;
+    int         begin, end;
+    JobCounter* counter;
+} Job;
+
+// Chase-Lev work-stealing deque, fixed size (C11 formulation of
+// Lê, Pop, Cohen & Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013). The owner pushes and
+// takes at `bottom`; thieves take at `top`.
+//
+// Jobs are stored by value and copied out before the CAS that claims
+// them: the owner only rewrites slot `t` once `top` has moved past `t`,
+// in which case the CAS fails and the (possibly torn) copy is dropped.
+// Pointers into a pool would not do: a thief can sleep between claiming
+// a job and reading it for as long as the owner takes to wrap around.
+typedef struct {
+    _Alignas(64) atomic_long top;
+    _Alignas(64) atomic_long bottom;
+    Job      jobs[JOBS_DEQUE_SIZE];
+    uint32_t rng;   // victim selection
+} Worker;
+
+static Worker*      workers = NULL;   // [0] is the main thread's
+static SDL_Thread*  threads[JOBS_MAX_THREADS];
+static int          threadCount = 0;
+static SDL_sem*     wake = NULL;
+static atomic_int   sleepers = 0;
+static atomic_int   quit = 0;
+static _Thread_local int self = -1;   // index in workers[], -1 outside the pool
+
+// ---- deque ------------------------------------------------------------------
+
+static int push(Worker* w, const Job* job) {
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+    if (b - t >= JOBS_DEQUE_SIZE) return -1;
+    w->jobs[b & (JOBS_DEQUE_SIZE - 1)] = *job;
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    return 0;
+}
+
+static int take(Worker* w, Job* job) {
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&w->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return 0;
+    }
+    *job = w->jobs[b & (JOBS_DEQUE_SIZE - 1)];
+    if (t == b) {
+        // Last job: race the thieves for it
+        int won = atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                          memory_order_seq_cst,
+                                                          memory_order_relaxed);
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return 1;
+}
+
+static int steal(Worker* w, Job* job) {
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+    if (t >= b) return 0;
+    *job = w->jobs[t & (JOBS_DEQUE_SIZE - 1)];
+    // Fails if another thief (or the owner) got it first
+    return atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                   memory_order_seq_cst,
+                                                   memory_order_relaxed);
+}
+
+// ---- scheduling -------------------------------------------------------------
+
+static void execute(const Job* job) {
+    job->fn(job->data, job->begin, job->end);
+    if (job->counter) atomic_fetch_sub_explicit(&job->counter->pending, 1, memory_order_release);
+}
+
+// Own deque first (newest job, still in cache), then the oldest job of
+// the others, starting at a random one.
+static int find_job(Job* job) {
+    Worker* w = &workers[self];
+    if (take(w, job)) return 1;
+    if (threadCount == 1) return 0;
+
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+    int start = (int)(w->rng % (uint32_t)threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        int victim = (start + i) % threadCount;
+        if (victim == self) continue;
+        if (steal(&workers[victim], job)) return 1;
+    }
+    return 0;
+}
+
+static void wake_workers(int jobs) {
+    // Pairs with the sleeper's increment: either it sees our job when
+    // it looks one last time, or we see it asleep
+    atomic_thread_fence(memory_order_seq_cst);
+    int asleep = atomic_load_explicit(&sleepers, memory_order_relaxed);
+    for (int i = 0; i < asleep && i < jobs; i++) SDL_SemPost(wake);
+}
+
+static void pin(int worker) {
+#ifdef __linux__
+    int cpus = SDL_GetCPUCount();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)worker;
+#endif
+}
+
+static int worker_main(void* arg) {
+    self = (int)(intptr_t)arg;
+    // Worker i on core i: the main thread is left to the scheduler
+    pin(self);
+    trace_thread_name("job worker");
+
+    int idle = 0;
+    Job job;
+    while (!atomic_load_explicit(&quit, memory_order_relaxed)) {
+        if (find_job(&job)) {
+            execute(&job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < IDLE_SPINS) {
+            cpu_relax();
+            continue;
+        }
+
+        atomic_fetch_add_explicit(&sleepers, 1, memory_order_seq_cst);
+        int found = find_job(&job);
+        if (!found && !atomic_load_explicit(&quit, memory_order_relaxed)) SDL_SemWait(wake);
+        atomic_fetch_sub_explicit(&sleepers, 1, memory_order_relaxed);
+        if (found) execute(&job);
+        idle = 0;
+    }
+    return 0;
+}
+
+// ---- API --------------------------------------------------------------------
+
+int jobs_init(int count) {
+    jobs_destroy();
+    if (count <= 0) count = SDL_GetCPUCount();
+    if (count < 1) count = 1;
+    if (count > JOBS_MAX_THREADS) count = JOBS_MAX_THREADS;
+
+    workers = aligned_alloc(64, sizeof(Worker) * count);
+    wake = SDL_CreateSemaphore(0);
+    if (!workers || !wake) {
+        fprintf(stderr, "jobs: cannot allocate %d deques\n", count);
+        jobs_destroy();
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        atomic_init(&workers[i].top, 0);
+        atomic_init(&workers[i].bottom, 0);
+        workers[i].rng = 0x9e3779b9u * (uint32_t)(i + 1);
+    }
+    atomic_store(&quit, 0);
+    self = 0;
+    threadCount = count;
+
+    for (int i = 1; i < count; i++) {
+        threads[i] = SDL_CreateThread(worker_main, "jobs", (void*)(intptr_t)i);
+        if (!threads[i]) {
+            fprintf(stderr, "jobs: could not start worker %d, using %d threads\n", i, i);
+            threadCount = i;
+            break;
+        }
+    }
+    return 0;
+}
+
+void jobs_destroy(void) {
+    if (threadCount > 0) {
+        atomic_store(&quit, 1);
+        for (int i = 1; i < threadCount; i++) SDL_SemPost(wake);
+        for (int i = 1; i < threadCount; i++) SDL_WaitThread(threads[i], NULL);
+    }
+    if (wake) SDL_DestroySemaphore(wake);
+    wake = NULL;
+    free(workers);
+    workers = NULL;
+    threadCount = 0;
+    self = -1;
+}
+
+int jobs_thread_count(void) {
+    return threadCount > 0 ? threadCount : 1;
+}
+
+int jobs_thread_index(void) {
+    return threadCount > 0 ? self : -1;
+}
+
+// Queues without waking anyone; returns 0 if it ran inline instead.
+static int submit(JobFn fn, void* data, int begin, int end, JobCounter* counter) {
+    if (self < 0 || threadCount == 0) {
+        fn(data, begin, end);
+        return 0;
+    }
+    Job job = { fn, data, begin, end, counter };
+    if (counter) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+    if (push(&workers[self], &job) != 0) {
+        execute(&job);   // deque full: no point queueing behind it
+        return 0;
+    }
+    return 1;
+}
+
+void jobs_run(JobFn fn, void* data, int begin, int end, JobCounter* counter) {
+    if (submit(fn, data, begin, end, counter)) wake_workers(1);
+}
+
+void jobs_wait(JobCounter* counter) {
+    int idle = 0;
+    Job job;
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0) {
+        if (self >= 0 && threadCount > 0 && find_job(&job)) {
+            execute(&job);
+            idle = 0;
+        } else if (++idle < IDLE_SPINS) {
+            cpu_relax();
+        } else {
+            // The jobs left are running on threads that may need this core
+            SDL_Delay(0);
+        }
+    }
+}
+
+void jobs_parallel_for(JobFn fn, void* data, int count, int grain) {
+    if (grain < 1) grain = 1;
+    if (count <= grain || jobs_thread_count() == 1 || self < 0) {
+        if (count > 0) fn(data, 0, count);
+        return;
+    }
+    JobCounter counter = { 0 };
+    int queued = 0;
+    // The first range is kept for this thread, which runs it right away
+    for (int begin = grain; begin < count; begin += grain) {
+        int end = begin + grain < count ? begin + grain : count;
+        queued += submit(fn, data, begin, end, &counter);
+    }
+    wake_workers(queued);
+    fn(data, 0, grain);
+    jobs_wait(&counter);
+}
@@ -0,0 +1,51 @@
+#ifndef CORE_JOBS_H
+#define CORE_JOBS_H
+
+#include <stdatomic.h>
+
+// ------------------------------------------------------------------
+// Job system (core/jobs.c):
+// a fixed pool of worker threads, each pinned to its own core, plus
+// the thread that called jobs_init() (the main thread). Every one of
+// them owns a Chase-Lev deque: it pushes and pops jobs at the bottom
+// without a lock, while idle threads steal the oldest jobs from the
+// top of a random victim's deque. Idle workers sleep on a semaphore
+// that submitters only touch when someone is asleep.
+//
+// Fork/join goes through counters: jobs_run() adds one to a
+// JobCounter, the job subtracts it when done, and jobs_wait() runs or
+// steals other jobs until the counter drops to zero, so waiting never
+// idles a thread that could help.
+//
+// Only the main thread and the workers submit; from any other thread,
+// or before jobs_init(), jobs simply run inline.
+// ------------------------------------------------------------------
+#define JOBS_MAX_THREADS 64
+#define JOBS_DEQUE_SIZE  4096   // jobs queued per thread (power of two)
+
+// Runs items [begin, end).
+typedef void (*JobFn)(void* data, int begin, int end);
+
+typedef struct {
+    atomic_int pending;
+} JobCounter;
+
+// `threads` counts the caller; <= 0 means one per core.
+int  jobs_init(int threads);
+void jobs_destroy(void);
+int  jobs_thread_count(void);
+// The calling thread's place in the pool: 0 for the one that called
+// jobs_init(), 1 .. jobs_thread_count() - 1 for the workers, -1 for
+// any other thread (or without a pool).
+int  jobs_thread_index(void);
+
+// Queues fn(data, begin, end); `counter` may be NULL (nobody waits).
+void jobs_run(JobFn fn, void* data, int begin, int end, JobCounter* counter);
+// Helps with queued jobs until every job counted by `counter` is done.
+void jobs_wait(JobCounter* counter);
+
+// Splits [0, count) into ranges of `grain` items, runs them on every
+// thread and returns when all are done.
+void jobs_parallel_for(JobFn fn, void* data, int count, int grain);
+
+#endif // CORE_JOBS_H
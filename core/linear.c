@@ -0,0 +1,85 @@
+// core/linear.c
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "linear.h"
+
+// Header of a heap allocation that did not fit; the data follows it
+struct LinearBlock {
+    LinearBlock* next;
+    size_t size;
+    unsigned char pad[LINEAR_ALIGN - sizeof(void*) - sizeof(size_t)];
+};
+
+static size_t round_up(size_t size) {
+    return (size + LINEAR_ALIGN - 1) & ~(size_t)(LINEAR_ALIGN - 1);
+}
+
+int linear_init(LinearArena* arena, size_t size) {
+    memset(arena, 0, sizeof(*arena));
+    size = round_up(size);
+    if (size == 0) return 0;
+    arena->base = aligned_alloc(LINEAR_ALIGN, size);
+    if (!arena->base) return -1;
+    arena->size = size;
+    return 0;
+}
+
+void linear_free(LinearArena* arena) {
+    linear_release(arena, (LinearMark){ 0, NULL, 0 });
+    free(arena->base);
+    memset(arena, 0, sizeof(*arena));
+}
+
+void* linear_alloc(LinearArena* arena, size_t size) {
+    size = round_up(size ? size : 1);
+    void* p;
+    if (size <= arena->size - arena->used) {
+        p = arena->base + arena->used;
+        arena->used += size;
+    } else {
+        LinearBlock* block = aligned_alloc(LINEAR_ALIGN, sizeof(LinearBlock) + size);
+        if (!block) return NULL;
+        block->next = arena->overflow;
+        block->size = size;
+        arena->overflow = block;
+        arena->overflowBytes += size;
+        p = block + 1;
+    }
+    size_t inUse = arena->used + arena->overflowBytes;
+    if (inUse > arena->high) arena->high = inUse;
+    if (inUse > arena->peak) arena->peak = inUse;
+    return p;
+}
+
+LinearMark linear_mark(const LinearArena* arena) {
+    return (LinearMark){ arena->used, arena->overflow, arena->overflowBytes };
+}
+
+void linear_release(LinearArena* arena, LinearMark mark) {
+    while (arena->overflow != mark.overflow) {
+        LinearBlock* block = arena->overflow;
+        arena->overflow = block->next;
+        free(block);
+    }
+    arena->overflowBytes = mark.overflowBytes;
+    arena->used = mark.used;
+}
+
+int linear_reset(LinearArena* arena) {
+    linear_release(arena, (LinearMark){ 0, NULL, 0 });
+    size_t need = arena->high;
+    arena->high = 0;
+    if (need <= arena->size) return 0;
+
+    // Doubling, so a slowly rising peak does not regrow every frame
+    size_t size = arena->size ? arena->size : LINEAR_ALIGN;
+    while (size < need) size *= 2;
+    unsigned char* grown = aligned_alloc(LINEAR_ALIGN, size);
+    if (!grown) return -1;
+    free(arena->base);
+    arena->base = grown;
+    arena->size = size;
+    arena->grows++;
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef CORE_LINEAR_H
+#define CORE_LINEAR_H
+
+#include <stddef.h>
+
+// ------------------------------------------------------------------
+// Linear (bump) allocator (core/linear.c):
+// allocations are carved one after another out of a single block and
+// are never freed one by one; the whole arena is released at once, or
+// rolled back to a mark. What does not fit goes to the heap, is freed
+// with the rest, and counts towards the high-water mark, so
+// linear_reset() can grow the block to cover it next time. Once the
+// block is big enough for the busiest use, the arena never touches
+// the heap again.
+//
+// An arena is not thread-safe: each belongs to one thread at a time.
+// ------------------------------------------------------------------
+#define LINEAR_ALIGN 64   // every allocation: a cache line, an AVX-512 vector
+
+typedef struct LinearBlock LinearBlock;
+
+typedef struct {
+    unsigned char* base;
+    size_t size;            // of the block
+    size_t used;            // of the block
+    LinearBlock* overflow;  // heap allocations that did not fit, newest first
+    size_t overflowBytes;
+    size_t high;            // most bytes in use at once since the last reset
+    size_t peak;            // ... ever
+    unsigned grows;         // times linear_reset() had to grow the block
+} LinearArena;
+
+typedef struct {
+    size_t used;
+    LinearBlock* overflow;
+    size_t overflowBytes;
+} LinearMark;
+
+// `size` may be 0: everything then goes to the heap until a reset.
+int   linear_init(LinearArena* arena, size_t size);
+void  linear_free(LinearArena* arena);
+
+// LINEAR_ALIGN-aligned, uninitialized; NULL only if the heap is exhausted.
+void* linear_alloc(LinearArena* arena, size_t size);
+
+// Releases everything allocated after `mark` was taken.
+LinearMark linear_mark(const LinearArena* arena);
+void       linear_release(LinearArena* arena, LinearMark mark);
+
+// Releases everything. If more than the block was needed since the last
+// reset, the block is reallocated to fit it (the only heap allocation a
+// warmed-up arena makes). Returns -1 if that fails; the arena keeps its
+// old block and stays usable.
+int   linear_reset(LinearArena* arena);
+
+#endif // CORE_LINEAR_H
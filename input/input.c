@@ -10,4 +10,7 @@ void findKey(Sint32 key, char* running) {
    else if (key == SDLK_2) {
       *running = 't';
    }
+   else if (key == SDLK_3) {
+      *running = 'g';
+   }
 }
@@ -1,66 +1,418 @@
 #include <stdlib.h>
+#include <string.h>
 #include <SDL2/SDL.h>
+#include <cglm/cglm.h>
 #include "utils/utils.h"
+#include "utils/headless.h"
 #include "input/input.h"
 #include "shape/shape.h"
+#include "shape/arena.h"
+#include "shape/batch.h"
+#include "render/camera.h"
+#include "render/state.h"
+#include "render/uniforms.h"
+#include "render/stream.h"
+#include "render/cull.h"
+#include "render/gpuprof.h"
+#include "render/pacing.h"
+#include "shader/cache.h"
+#include "shader/registry.h"
+#include "shader/shader.h"
+#include "raster/raster.h"
+#include "sim/sim.h"
+#include "sim/thread.h"
+#include "bench/bench.h"
+#include "bench/kernels.h"
+#include "bench/scaling.h"
+#include "core/cpu.h"
+#include "core/frame.h"
+#include "core/jobs.h"
+#include "bench/trace.h"
 
-int main() {
-    if (initSDL("Test", 1500, 700) != 0) {
+#define WIDTH  1500
+#define HEIGHT 700
+
+// Longest block in SDL_WaitEventTimeout() while idle; bounds how late the
+// once-per-frame housekeeping (shader polling) runs
+#define IDLE_WAIT_MS 100
+
+static int init_gl_backend(void) {
+    if (initSDL("Test", WIDTH, HEIGHT) != 0 || initGL() != 0) {
+        return -1;
+    }
+    blackScreen();
+    shader_parallel_init((GLADloadproc)SDL_GL_GetProcAddress);
+    // Time the buffer streaming strategies this driver offers (instances of
+    // a full field are ~640 KiB per frame) and stream with the fastest one.
+    stream_pick_strategy(640 * 1024);
+
+    // Every static mesh is packed into one shared VBO/IBO/VAO
+    return arena_init(1024, 4096) != 0 || batch_init() != 0 || uniforms_init() != 0 ? -1 : 0;
+}
+
+// Size of what is drawn to in pixels: on HiDPI displays the GL drawable
+// is larger than the window (SDL_WINDOW_ALLOW_HIGHDPI)
+static void drawable_size(SDL_Window* window, int software, int headless, int* w, int* h) {
+    if (headless)      getHeadlessSize(w, h);
+    else if (software) SDL_GetWindowSize(window, w, h);
+    else               SDL_GL_GetDrawableSize(window, w, h);
+}
+
+// Same setup as init_gl_backend(), on an EGL context with an FBO target
+static int init_headless_backend(void) {
+    if (initHeadless(WIDTH, HEIGHT) != 0) {
+        return -1;
+    }
+    shader_parallel_init((GLADloadproc)getHeadlessProcAddress);
+    stream_pick_strategy(640 * 1024);
+    return arena_init(1024, 4096) != 0 || batch_init() != 0 || uniforms_init() != 0 ? -1 : 0;
+}
+
+int main(int argc, char** argv) {
+    // Picks the CPU kernels, and logs the choice, before anything runs one
+    cpu_init();
+
+    // --soft: render with the CPU rasterizer instead of the GL driver
+    // --headless: no window, render N frames of one scene into an FBO
+    //             (--frames=N, --scene=c|t|g) and save the last one (--out=)
+    // --bench: time --frames=N frames of --scene after --warmup=N more,
+    //          vsync off, and print/write (--report=) the statistics
+    // --gpuprof: time the frame's passes on the GPU, report every 120 frames
+    // --trace=file.json: record CPU zones for chrome://tracing (F9 pauses)
+    // --no-shader-cache: always compile GLSL instead of loading program binaries
+    // --vsync=on|off|adaptive: swap interval (default on, off when benching)
+    // --fps=N: cap the frame rate at N
+    // --bench-jobs=N: measure the job system's speedup up to N threads
+    //                 (0: one per core) and exit
+    // --bench-transform=N: time the batch transform kernel on N objects and exit
+    // (--headless alone simulates SIM_STEP per frame, so its image only
+    // depends on --frames)
+    // GRAPHICS_SIMD=scalar|sse|avx2|avx512 in the environment forces the
+    // CPU kernels down to that instruction set (core/cpu.h)
+    int software = 0, headless = 0, benchmark = 0, profileGpu = 0, frames = 0, warmup = 30;
+    int shaderCache = 1, vsyncSet = 0;
+    PacingVsync vsync = PACING_VSYNC_ON;
+    double fpsLimit = 0.0;
+    char scene = 'c';
+    const char* out = NULL;
+    const char* report = NULL;
+    const char* tracePath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--soft") == 0) software = 1;
+        else if (strcmp(argv[i], "--headless") == 0) headless = 1;
+        else if (strcmp(argv[i], "--bench") == 0) benchmark = 1;
+        else if (strcmp(argv[i], "--gpuprof") == 0) profileGpu = 1;
+        else if (strcmp(argv[i], "--no-shader-cache") == 0) shaderCache = 0;
+        else if (strncmp(argv[i], "--frames=", 9) == 0) frames = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--warmup=", 9) == 0) warmup = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--scene=", 8) == 0) scene = argv[i][8];
+        else if (strncmp(argv[i], "--out=", 6) == 0) out = argv[i] + 6;
+        else if (strncmp(argv[i], "--report=", 9) == 0) report = argv[i] + 9;
+        else if (strncmp(argv[i], "--trace=", 8) == 0) tracePath = argv[i] + 8;
+        else if (strncmp(argv[i], "--fps=", 6) == 0) fpsLimit = atof(argv[i] + 6);
+        else if (strncmp(argv[i], "--bench-jobs=", 13) == 0) {
+            return bench_jobs_scaling(atoi(argv[i] + 13)) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        else if (strncmp(argv[i], "--bench-transform=", 18) == 0) {
+            return bench_transform_kernel(atoi(argv[i] + 18)) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        else if (strncmp(argv[i], "--vsync=", 8) == 0) {
+            vsyncSet = 1;
+            if (strcmp(argv[i] + 8, "off") == 0)           vsync = PACING_VSYNC_OFF;
+            else if (strcmp(argv[i] + 8, "adaptive") == 0) vsync = PACING_VSYNC_ADAPTIVE;
+            else                                           vsync = PACING_VSYNC_ON;
+        }
+    }
+    if (headless) software = 0;
+    if (frames <= 0) frames = benchmark ? 500 : 1;
+    if (!benchmark) warmup = 0;
+    if (headless && !benchmark && !out) out = "headless.ppm";
+    // Before any backend, so the rasterizer's workers find the session
+    if (tracePath) trace_start(tracePath);
+    // One thread per core for per-frame CPU work (culling, transforms)
+    if (jobs_init(0) != 0) {
         return EXIT_FAILURE;
     }
-    if (initGL() != 0) {
+    // Transient per-frame arrays, and scratch for every job thread
+    if (frame_memory_init(1 << 20, 64 << 10) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    if (headless) {
+        if (init_headless_backend() != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (software) {
+        if (initSDLSoftware("Test", WIDTH, HEIGHT) != 0 || raster_init(WIDTH, HEIGHT, 0) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (init_gl_backend() != 0) {
         return EXIT_FAILURE;
     }
     SDL_Window* window = getSDLWindow();
+    int drawWidth, drawHeight;
+    drawable_size(window, software, headless, &drawWidth, &drawHeight);
+    camera_init(drawWidth, drawHeight);
+    if (profileGpu && !software) gpuprof_init();
+    int frameScope = gpuprof_scope("frame");
+    int clearScope = gpuprof_scope("clear");
+    // Benchmarks measure the renderer, not the display refresh
+    if (benchmark && !vsyncSet) vsync = PACING_VSYNC_OFF;
+    pacing_init(vsync, fpsLimit, window && !software);
+    if (benchmark && bench_init(frames, warmup, !software) != 0) {
+        return EXIT_FAILURE;
+    }
 
     // *** MODIFIED ***
     // Before: char running = 't';
     // Now: Start with no shape selected (so everything stays black until a key is pressed).
-    char running = 0;
+    char running = headless || benchmark ? scene : 0;
+    int frame = 0;
+    // Interactive only: a window nobody can see is not drawn, and with no
+    // scene selected (nothing animating) a frame is drawn only when
+    // something changed. Otherwise the loop blocks waiting for events.
+    int interactive = !headless && !benchmark;
+    int visible = 1, redraw = 1;
+    Uint64 loopStart = 0, idleTicks = 0;
 
-    blackScreen();
+    if (shaderCache && !software) shader_cache_open("shaders.cache");
+    Uint64 initStart = SDL_GetPerformanceCounter();
     init_cube();
     init_triangle();
+    printf("shapes ready in %.1f ms\n", (double)(SDL_GetPerformanceCounter() - initStart) * 1000.0
+                                         / (double)SDL_GetPerformanceFrequency());
+    if (!software) arena_report();
+    init_field(100);
 
+    // The scene is simulated in fixed steps on its own thread; frames
+    // show a blend of its last two states. A plain --headless run steps
+    // once per frame on this thread instead.
+    SimState shown;
+    sim_init(&shown);
+    int stepPerFrame = headless && !benchmark;
+    if (!stepPerFrame && sim_thread_start(SIM_STEP) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    loopStart = SDL_GetPerformanceCounter();
     while (running != 'f') {
+        TRACE_ZONE("frame");
+        TraceZone zone = trace_zone_begin("events");
         SDL_Event ev;
-        while (SDL_PollEvent(&ev)) {
+        int pending = SDL_PollEvent(&ev);
+        int idle = interactive && (!visible || (!running && !redraw));
+        if (!pending && idle) {
+            Uint64 waitStart = SDL_GetPerformanceCounter();
+            pending = SDL_WaitEventTimeout(&ev, IDLE_WAIT_MS);
+            idleTicks += SDL_GetPerformanceCounter() - waitStart;
+            pacing_idle();
+        }
+        for (; pending; pending = SDL_PollEvent(&ev)) {
             switch (ev.type) {
                 case SDL_QUIT:
                     running = 'f';
                     break;
 
                 case SDL_KEYDOWN:
+                    if (ev.key.keysym.sym == SDLK_F9) trace_set_enabled(!trace_enabled());
                     findKey(ev.key.keysym.sym, &running);
+                    redraw = 1;
+                    break;
+
+                case SDL_WINDOWEVENT:
+                    switch (ev.window.event) {
+                        case SDL_WINDOWEVENT_HIDDEN:
+                        case SDL_WINDOWEVENT_MINIMIZED:
+                            visible = 0;
+                            break;
+                        case SDL_WINDOWEVENT_SHOWN:
+                        case SDL_WINDOWEVENT_RESTORED:
+                        case SDL_WINDOWEVENT_MAXIMIZED:
+                        case SDL_WINDOWEVENT_EXPOSED:
+                            visible = 1;
+                            redraw = 1;
+                            break;
+                        case SDL_WINDOWEVENT_SIZE_CHANGED:
+                            // Applied by camera_update() below
+                            drawable_size(window, software, headless, &drawWidth, &drawHeight);
+                            camera_resize(drawWidth, drawHeight);
+                            redraw = 1;
+                            break;
+                        default:
+                            break;
+                    }
                     break;
 
                 default:
                     break;
             }
         }
+        trace_zone_end(&zone);
 
-        // Always clear the screen each frame:
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Picks up programs whose compile finished since the last frame
+        if (!software) shader_registry_poll();
+        // The viewport follows every size change; the rasterizer's tiles
+        // are reallocated only once a drag-resize has settled
+        int cameraChanges = camera_update();
+        const Camera* camera = camera_current();
+        if ((cameraChanges & CAMERA_RESIZED) && !software) {
+            glViewport(0, 0, camera->width, camera->height);
+            redraw = 1;
+        }
+        if ((cameraChanges & CAMERA_SETTLED) && software) {
+            if (raster_resize(camera->width, camera->height) != 0) {
+                // Still drawing at the old size: match the projection to it
+                int pitch;
+                raster_pixels(&drawWidth, &drawHeight, &pitch);
+                camera_resize(drawWidth, drawHeight);
+            }
+            redraw = 1;
+        }
+        // Nothing to draw: the simulation waits too
+        int drawing = !interactive || (visible && (running || redraw));
+        sim_thread_pause(!drawing);
+        if (!drawing) continue;
+        redraw = 0;
+        frame_memory_begin();
+        if (stepPerFrame) sim_step(&shown, SIM_STEP);
+        else              sim_thread_view(&shown);
 
-        // Only draw if running == 'c' or 't'; otherwise remain black:
+        if (benchmark) bench_begin_frame();
+        gpuprof_begin_frame();
+        int frameEvent = gpuprof_begin(frameScope);
+
+        // Always clear the screen each frame (the rasterizer clears its
+        // tiles as it draws them):
+        if (!software) {
+            int clearEvent = gpuprof_begin(clearScope);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            gpuprof_end(clearEvent);
+        }
+
+        // Camera: matrices recomputed by camera_update() only when they
+        // change, shared by every program via the Frame block.
+        uniforms_begin_frame(camera, (float)shown.time);
+
+        // The draw_* calls below only queue their instances; everything
+        // is issued in one go by batch_flush() (raster_flush() in software).
+        if (software) raster_begin();
+        else          batch_begin();
+
+        // Only draw if running == 'c', 't' or 'g'; otherwise remain black:
+        zone = trace_zone_begin("draw");
         switch (running) {
             case 'c':
-                draw_cube();
+                draw_cube(shown.spin);
                 break;
             case 't':
-                draw_triangle();
+                draw_triangle(shown.spin);
+                break;
+            case 'g':
+                draw_field(shown.spin);
                 break;
             default:
                 // *** MODIFIED ***
                 // No shape selected: do nothing (stay black)
                 break;
         }
+        trace_zone_end(&zone);
 
-        SDL_GL_SwapWindow(window);
+        zone = trace_zone_begin("flush");
+        if (software) {
+            raster_flush((vec4*)camera->viewProj);
+        } else {
+            batch_flush();
+            uniforms_end_frame();
+            gpuprof_end(frameEvent);
+            gpuprof_end_frame();
+        }
+        trace_zone_end(&zone);
+
+        zone = trace_zone_begin("pace");
+        pacing_wait();
+        trace_zone_end(&zone);
+
+        if (benchmark) bench_before_swap();
+        zone = trace_zone_begin("swap");
+        // Headless there is nothing to present; wait for the GPU instead
+        if (software)      raster_present(window);
+        else if (headless) glFinish();
+        else               SDL_GL_SwapWindow(window);
+        trace_zone_end(&zone);
+        pacing_presented();
+        if (benchmark) bench_end_frame();
+        state_end_frame();
+        cull_end_frame();
+        if (benchmark) {
+            StateStats gl = state_stats();
+            bench_count(BENCH_GL_ISSUED, gl.issued);
+            bench_count(BENCH_GL_ELIDED, gl.elided);
+            CullStats cull = cull_stats();
+            bench_count(BENCH_CULL_TESTED, cull.tested);
+            bench_count(BENCH_CULL_VISIBLE, cull.visible);
+            bench_count(BENCH_CULL_MS, cull.ms);
+            if (!software) {
+                BatchStats batch = batch_stats();
+                bench_count(BENCH_DRAWS, batch.commands);
+                bench_count(BENCH_PROGRAMS, batch.programs);
+                bench_count(BENCH_DRAW_CALLS, batch.glDrawCalls);
+            }
+        }
+        frame_memory_end();
+
+        frame++;
+        if ((headless || benchmark) && frame >= warmup + frames) {
+            running = 'f';
+        }
+        if (gpuprof_active() && frame % 120 == 0) {
+            gpuprof_report(stdout);
+            state_report(stdout);
+            batch_report(stdout);
+            cull_report(stdout);
+        }
+    }
+
+    if (interactive) {
+        Uint64 freq = SDL_GetPerformanceFrequency();
+        double total = (double)(SDL_GetPerformanceCounter() - loopStart) / (double)freq;
+        double idle = (double)idleTicks / (double)freq;
+        printf("loop: %d frames, active %.1f s, idle %.1f s (%.0f%%)\n", frame,
+               total - idle, idle, total > 0.0 ? 100.0 * idle / total : 0.0);
     }
+    if (headless && out) saveHeadlessFrame(out);
+    if (benchmark) {
+        bench_report(report, scene,
+                     software ? "software" : headless ? "gl-headless" : "gl-window",
+                     camera_current()->width, camera_current()->height);
+        bench_destroy();
+    }
+    sim_thread_stop();
+    jobs_destroy();
+    pacing_report(stdout);
+    frame_memory_report(stdout);
+    gpuprof_report(stdout);
+    if (!software) {
+        state_report(stdout);
+        batch_report(stdout);
+    }
+    cull_report(stdout);
+    gpuprof_destroy();
+    trace_stop();
 
-    closeGL();
-    closeSDL();
+    close_field();
+    shader_cache_close();
+    shader_registry_destroy();
+    raster_destroy();
+    uniforms_destroy();
+    batch_destroy();
+    arena_destroy();
+    frame_memory_destroy();
+    if (headless) {
+        closeHeadless();
+    } else {
+        closeGL();
+        closeSDL();
+    }
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,747 @@
+// raster/raster.c
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raster.h"
+#include "../bench/trace.h"
+#include "../core/cpu.h"
+
+// -----------------------------------------------------------------------------
+// Conventions follow GL so both backends produce the same picture: clip
+// space is transformed with viewProj * model, triangles are clipped against
+// the near and far planes, depth is z_ndc * 0.5 + 0.5 compared with LESS,
+// pixels are sampled at their centers with a top-left fill rule, and a
+// triangle takes the color of its first (provoking) vertex. Row 0 is the top
+// of the image, as SDL surfaces expect.
+//
+// Edge function i (opposite vertex i) is e_i(x, y) = a_i*x + b_i*y + c_i,
+// oriented so the interior is positive. Setup is done in double and stored
+// as float; depth is the plane z(x, y) = z0 + zx*x + zy*y.
+//
+// The color and depth buffers are padded to whole tiles so every tile and
+// every 8x8 block is complete in memory; the padding is never presented.
+//
+// Clearing is lazy, per 8x8 block: a block is cleared the first time a
+// triangle reaches it in a frame, and blocks nothing touched are only
+// repainted if they still hold last frame's pixels. An empty or sparse
+// frame therefore writes almost no memory.
+//
+// Blocks are shaded by raster_kernel.inc, built once per instruction set;
+// raster_init() picks the one for the level core/cpu.h chose.
+// -----------------------------------------------------------------------------
+
+#define BLOCK 8
+
+#define BLOCK_TOUCHED 0x1   // cleared and drawn to this frame
+#define BLOCK_DIRTY   0x2   // color differs from the clear color
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    float    a[3], b[3], c[3];
+    float    z0, zx, zy;
+    float    zmin;
+    uint32_t color;
+    int      topLeft;                  // bit i: pixels exactly on edge i are in
+    int      minX, minY, maxX, maxY;   // inclusive pixel bounds, on screen
+} Tri;
+
+typedef struct {
+    uint32_t* items;
+    int count, cap;
+} Bin;
+
+// Everything one thread produces during setup; only that thread writes it.
+typedef struct {
+    Tri*   tris;
+    int    triCount, triCap;
+    Bin*   bins;                       // one per tile
+    vec4*  clip;                       // transformed vertices of one instance
+    int    clipCap;
+    unsigned triangles, binned, blocksSkipped;
+    int    failed;
+} ThreadData;
+
+typedef struct {
+    float*    vertices;
+    GLuint*   indices;
+    uint32_t* colors;                  // packed ARGB per vertex
+    int vertexCount, indexCount, stride;
+} RasterMesh;
+
+static int active = 0;
+
+static int width, height;
+static int pitch, rows;                // padded to whole tiles
+static int tilesX, tilesY;
+static uint32_t* color = NULL;
+static float*    depth = NULL;
+static float*    blockMax = NULL;     // max stored depth per 8x8 block
+static uint8_t*  blockState = NULL;   // BLOCK_* bits per 8x8 block
+static uint32_t  clearColor = 0xff000000u;
+static SDL_Surface* frontSurface = NULL;
+
+// Everything alloc_targets() sets up, so raster_resize() can build new
+// targets next to the old ones and keep the old ones if that fails
+typedef struct {
+    int width, height, pitch, rows, tilesX, tilesY;
+    uint32_t* color;
+    float* depth;
+    float* blockMax;
+    uint8_t* blockState;
+    SDL_Surface* frontSurface;
+    Bin* bins[RASTER_MAX_THREADS];
+} Targets;
+
+static RasterMesh meshes[RASTER_MAX_MESHES];
+static int meshCount = 0;
+
+static int*  instMesh = NULL;
+static mat4* instModels = NULL;
+static int   instCount = 0, instCap = 0, modelCap = 0;
+static mat4  frameViewProj;
+
+static ThreadData threadData[RASTER_MAX_THREADS];
+static int threadCount = 0;
+static SDL_Thread* workers[RASTER_MAX_THREADS];
+static SDL_sem* startSem[RASTER_MAX_THREADS];   // one per worker, so none runs twice
+static SDL_sem* doneSem = NULL;
+static SDL_atomic_t quit;
+static SDL_atomic_t nextTile;
+static void (*phase)(int thread) = NULL;
+static int (*draw_block)(const Tri* t, int bx, int y0, int y1) = NULL;   // see pick_kernel()
+
+static void pick_kernel(void);
+
+static RasterStats stats;
+
+// ---- helpers ----------------------------------------------------------------
+
+static double elapsed_ms(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0
+         / (double)SDL_GetPerformanceFrequency();
+}
+
+static int grow(void** array, int* cap, int need, size_t size) {
+    if (need <= *cap) return 0;
+    int newCap = *cap ? *cap : 64;
+    while (newCap < need) newCap *= 2;
+    void* grown = realloc(*array, size * newCap);
+    if (!grown) return -1;
+    *array = grown;
+    *cap = newCap;
+    return 0;
+}
+
+static uint32_t pack_color(const float* rgb) {
+    uint32_t c = 0xff000000u;
+    for (int i = 0; i < 3; i++) {
+        float v = rgb[i] < 0.0f ? 0.0f : rgb[i] > 1.0f ? 1.0f : rgb[i];
+        c |= (uint32_t)(v * 255.0f + 0.5f) << (16 - 8 * i);
+    }
+    return c;
+}
+
+// ---- thread pool ------------------------------------------------------------
+
+static int worker_main(void* arg) {
+    int id = (int)(intptr_t)arg;
+    trace_thread_name("raster worker");
+    for (;;) {
+        SDL_SemWait(startSem[id]);
+        if (SDL_AtomicGet(&quit)) break;
+        phase(id);
+        SDL_SemPost(doneSem);
+    }
+    return 0;
+}
+
+// Runs fn(thread) on every thread (the caller is thread 0) and waits.
+static void run_phase(void (*fn)(int thread)) {
+    phase = fn;
+    for (int i = 1; i < threadCount; i++) SDL_SemPost(startSem[i]);
+    fn(0);
+    for (int i = 1; i < threadCount; i++) SDL_SemWait(doneSem);
+}
+
+// ---- framebuffer ------------------------------------------------------------
+
+static void free_targets(void) {
+    free(color);
+    free(depth);
+    free(blockMax);
+    free(blockState);
+    color = NULL; depth = NULL; blockMax = NULL; blockState = NULL;
+    if (frontSurface) SDL_FreeSurface(frontSurface);
+    frontSurface = NULL;
+    for (int t = 0; t < RASTER_MAX_THREADS; t++) {
+        ThreadData* td = &threadData[t];
+        if (!td->bins) continue;
+        for (int i = 0; i < tilesX * tilesY; i++) free(td->bins[i].items);
+        free(td->bins);
+        td->bins = NULL;
+    }
+}
+
+// Moves the current targets out, leaving none behind.
+static Targets take_targets(void) {
+    Targets t = { width, height, pitch, rows, tilesX, tilesY,
+                  color, depth, blockMax, blockState, frontSurface, {0} };
+    color = NULL; depth = NULL; blockMax = NULL; blockState = NULL;
+    frontSurface = NULL;
+    for (int i = 0; i < RASTER_MAX_THREADS; i++) {
+        t.bins[i] = threadData[i].bins;
+        threadData[i].bins = NULL;
+    }
+    return t;
+}
+
+// Makes `t` current; there must be none (free_targets() or take_targets()).
+static void put_targets(const Targets* t) {
+    width = t->width; height = t->height;
+    pitch = t->pitch; rows = t->rows;
+    tilesX = t->tilesX; tilesY = t->tilesY;
+    color = t->color; depth = t->depth;
+    blockMax = t->blockMax; blockState = t->blockState;
+    frontSurface = t->frontSurface;
+    for (int i = 0; i < RASTER_MAX_THREADS; i++) threadData[i].bins = t->bins[i];
+}
+
+static int alloc_targets(int w, int h) {
+    width  = w;
+    height = h;
+    tilesX = (w + RASTER_TILE - 1) / RASTER_TILE;
+    tilesY = (h + RASTER_TILE - 1) / RASTER_TILE;
+    pitch  = tilesX * RASTER_TILE;
+    rows   = tilesY * RASTER_TILE;
+
+    size_t pixels = (size_t)pitch * rows;
+    color    = aligned_alloc(64, pixels * sizeof(uint32_t));
+    depth    = aligned_alloc(64, pixels * sizeof(float));
+    blockMax = malloc(pixels / (BLOCK * BLOCK) * sizeof(float));
+    blockState = malloc(pixels / (BLOCK * BLOCK));
+    if (!color || !depth || !blockMax || !blockState) return -1;
+    // Everything dirty: the first frame paints the whole clear color
+    memset(blockState, BLOCK_DIRTY, pixels / (BLOCK * BLOCK));
+
+    for (int t = 0; t < threadCount; t++) {
+        threadData[t].bins = calloc((size_t)tilesX * tilesY, sizeof(Bin));
+        if (!threadData[t].bins) return -1;
+    }
+
+    frontSurface = SDL_CreateRGBSurfaceWithFormatFrom(color, width, height, 32,
+                                                      pitch * (int)sizeof(uint32_t),
+                                                      SDL_PIXELFORMAT_ARGB8888);
+    return frontSurface ? 0 : -1;
+}
+
+int raster_init(int w, int h, int threads) {
+    raster_destroy();
+
+    if (threads <= 0) threads = SDL_GetCPUCount();
+    if (threads < 1) threads = 1;
+    if (threads > RASTER_MAX_THREADS) threads = RASTER_MAX_THREADS;
+    threadCount = threads;
+
+    if (alloc_targets(w, h) != 0) {
+        fprintf(stderr, "raster: failed to allocate a %dx%d target\n", w, h);
+        raster_destroy();
+        return -1;
+    }
+
+    SDL_AtomicSet(&quit, 0);
+    doneSem = SDL_CreateSemaphore(0);
+    for (int i = 1; i < threadCount; i++) {
+        startSem[i] = SDL_CreateSemaphore(0);
+        workers[i] = startSem[i]
+                   ? SDL_CreateThread(worker_main, "raster", (void*)(intptr_t)i) : NULL;
+        if (!workers[i]) {
+            if (startSem[i]) SDL_DestroySemaphore(startSem[i]);
+            startSem[i] = NULL;
+            fprintf(stderr, "raster: could not start worker %d, using %d threads\n", i, i);
+            threadCount = i;
+            break;
+        }
+    }
+
+    active = 1;
+    pick_kernel();
+    printf("raster: %dx%d, %d threads, %dx%d tiles, %s kernel\n",
+           width, height, threadCount, tilesX, tilesY, raster_kernel_name());
+    return 0;
+}
+
+void raster_destroy(void) {
+    if (doneSem) {
+        SDL_AtomicSet(&quit, 1);
+        for (int i = 1; i < threadCount; i++) {
+            SDL_SemPost(startSem[i]);
+            SDL_WaitThread(workers[i], NULL);
+            SDL_DestroySemaphore(startSem[i]);
+            startSem[i] = NULL;
+        }
+        SDL_DestroySemaphore(doneSem);
+        doneSem = NULL;
+    }
+
+    free_targets();
+    for (int t = 0; t < RASTER_MAX_THREADS; t++) {
+        free(threadData[t].tris);
+        free(threadData[t].clip);
+    }
+    memset(threadData, 0, sizeof(threadData));
+
+    for (int i = 0; i < meshCount; i++) {
+        free(meshes[i].vertices);
+        free(meshes[i].indices);
+        free(meshes[i].colors);
+    }
+    meshCount = 0;
+
+    free(instMesh);
+    free(instModels);
+    instMesh = NULL; instModels = NULL;
+    instCount = instCap = modelCap = 0;
+    threadCount = 0;
+    active = 0;
+}
+
+int raster_active(void) {
+    return active;
+}
+
+int raster_resize(int w, int h) {
+    if (w == width && h == height) return 0;
+    Targets old = take_targets();
+    if (alloc_targets(w, h) != 0) {
+        free_targets();   // whatever was allocated
+        put_targets(&old);
+        fprintf(stderr, "raster: failed to resize to %dx%d, staying at %dx%d\n",
+                w, h, width, height);
+        return -1;
+    }
+    Targets resized = take_targets();
+    put_targets(&old);
+    free_targets();
+    put_targets(&resized);
+    return 0;
+}
+
+// ---- meshes & submission ----------------------------------------------------
+
+int raster_add_mesh(const Mesh* mesh) {
+    if (meshCount == RASTER_MAX_MESHES || mesh->stride < 6) return -1;
+
+    RasterMesh* m = &meshes[meshCount];
+    m->vertices = malloc(sizeof(float) * mesh->vertexCount * mesh->stride);
+    m->indices  = malloc(sizeof(GLuint) * mesh->indexCount);
+    m->colors   = malloc(sizeof(uint32_t) * mesh->vertexCount);
+    if (!m->vertices || !m->indices || !m->colors) {
+        free(m->vertices); free(m->indices); free(m->colors);
+        return -1;
+    }
+    memcpy(m->vertices, mesh->vertices, sizeof(float) * mesh->vertexCount * mesh->stride);
+    memcpy(m->indices, mesh->indices, sizeof(GLuint) * mesh->indexCount);
+    for (int v = 0; v < mesh->vertexCount; v++) {
+        m->colors[v] = pack_color(&mesh->vertices[v * mesh->stride + 3]);
+    }
+    m->vertexCount = mesh->vertexCount;
+    m->indexCount  = mesh->indexCount;
+    m->stride      = mesh->stride;
+    return meshCount++;
+}
+
+void raster_clear_color(float r, float g, float b) {
+    uint32_t c = pack_color((float[3]){r, g, b});
+    if (c == clearColor) return;
+    clearColor = c;
+    if (blockState) memset(blockState, BLOCK_DIRTY, (size_t)pitch * rows / (BLOCK * BLOCK));
+}
+
+void raster_begin(void) {
+    instCount = 0;
+}
+
+void raster_submit(int mesh, const mat4* models, int count) {
+    if (mesh < 0 || mesh >= meshCount || count <= 0) return;
+    if (grow((void**)&instMesh, &instCap, instCount + count, sizeof(int)) != 0
+        || grow((void**)&instModels, &modelCap, instCount + count, sizeof(mat4)) != 0) {
+        fprintf(stderr, "raster_submit: out of memory, dropping %d instances\n", count);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) instMesh[instCount + i] = mesh;
+    memcpy(instModels[instCount], models, sizeof(mat4) * count);
+    instCount += count;
+}
+
+// ---- setup phase ------------------------------------------------------------
+
+static void bin_triangle(ThreadData* td, const Tri* tri) {
+    if (grow((void**)&td->tris, &td->triCap, td->triCount + 1, sizeof(Tri)) != 0) {
+        td->failed = 1;
+        return;
+    }
+    uint32_t index = (uint32_t)td->triCount;
+    td->tris[td->triCount++] = *tri;
+    td->triangles++;
+
+    for (int ty = tri->minY / RASTER_TILE; ty <= tri->maxY / RASTER_TILE; ty++) {
+        for (int tx = tri->minX / RASTER_TILE; tx <= tri->maxX / RASTER_TILE; tx++) {
+            Bin* bin = &td->bins[ty * tilesX + tx];
+            if (grow((void**)&bin->items, &bin->cap, bin->count + 1, sizeof(uint32_t)) != 0) {
+                td->failed = 1;
+                continue;
+            }
+            bin->items[bin->count++] = index;
+            td->binned++;
+        }
+    }
+}
+
+// Projects a clipped triangle to the screen and bins it.
+static void setup_triangle(ThreadData* td, const vec4 v[3], uint32_t rgb) {
+    double x[3], y[3], z[3];
+    for (int i = 0; i < 3; i++) {
+        double invW = 1.0 / v[i][3];
+        x[i] = (v[i][0] * invW * 0.5 + 0.5) * width;
+        y[i] = (0.5 - v[i][1] * invW * 0.5) * height;
+        z[i] =  v[i][2] * invW * 0.5 + 0.5;
+    }
+
+    double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0) return;
+    if (area < 0.0) {
+        // Either winding is drawn (no face culling), so make it positive
+        double t;
+        t = x[1]; x[1] = x[2]; x[2] = t;
+        t = y[1]; y[1] = y[2]; y[2] = t;
+        t = z[1]; z[1] = z[2]; z[2] = t;
+        area = -area;
+    }
+
+    double minX = fmin(x[0], fmin(x[1], x[2])), maxX = fmax(x[0], fmax(x[1], x[2]));
+    double minY = fmin(y[0], fmin(y[1], y[2])), maxY = fmax(y[0], fmax(y[1], y[2]));
+    Tri tri;
+    tri.minX = (int)floor(fmax(minX, 0.0));
+    tri.minY = (int)floor(fmax(minY, 0.0));
+    tri.maxX = (int)ceil(fmin(maxX, width - 1.0));
+    tri.maxY = (int)ceil(fmin(maxY, height - 1.0));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+    double zx = 0.0, zy = 0.0, z0 = 0.0;
+    tri.topLeft = 0;
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        double a = y[j] - y[k];
+        double b = x[k] - x[j];
+        double c = -(a * x[j] + b * y[j]);
+        tri.a[i] = (float)a;
+        tri.b[i] = (float)b;
+        tri.c[i] = (float)c;
+        // Edge j -> k: top edges run right, left edges run up (y is down)
+        double dy = y[k] - y[j], dx = x[k] - x[j];
+        if (dy < 0.0 || (dy == 0.0 && dx > 0.0)) tri.topLeft |= 1 << i;
+
+        zx += z[i] * a;
+        zy += z[i] * b;
+        z0 += z[i] * c;
+    }
+    tri.zx = (float)(zx / area);
+    tri.zy = (float)(zy / area);
+    tri.z0 = (float)(z0 / area);
+    tri.zmin  = (float)fmin(z[0], fmin(z[1], z[2]));
+    tri.color = rgb;
+    bin_triangle(td, &tri);
+}
+
+// Sutherland-Hodgman against one clip-space plane: side 0 keeps z >= -w,
+// side 1 keeps z <= w.
+static int clip_plane(const vec4* in, int n, vec4* out, int side) {
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        const float* cur = in[i];
+        const float* nxt = in[(i + 1) % n];
+        float dc = side ? cur[3] - cur[2] : cur[3] + cur[2];
+        float dn = side ? nxt[3] - nxt[2] : nxt[3] + nxt[2];
+        if (dc >= 0.0f) glm_vec4_copy((float*)cur, out[m++]);
+        if ((dc >= 0.0f) != (dn >= 0.0f)) {
+            float t = dc / (dc - dn);
+            for (int k = 0; k < 4; k++) out[m][k] = cur[k] + (nxt[k] - cur[k]) * t;
+            m++;
+        }
+    }
+    return m;
+}
+
+static void emit_triangle(ThreadData* td, const vec4 a, const vec4 b, const vec4 c,
+                          uint32_t rgb) {
+    const float* v[3] = { a, b, c };
+
+    // Trivially outside one of the six planes?
+    for (int axis = 0; axis < 3; axis++) {
+        int above = 0, below = 0;
+        for (int i = 0; i < 3; i++) {
+            above += v[i][axis] >  v[i][3];
+            below += v[i][axis] < -v[i][3];
+        }
+        if (above == 3 || below == 3) return;
+    }
+
+    int needsClip = 0;
+    for (int i = 0; i < 3; i++) {
+        needsClip |= v[i][2] < -v[i][3] || v[i][2] > v[i][3];
+    }
+    if (!needsClip) {
+        vec4 tri[3];
+        for (int i = 0; i < 3; i++) glm_vec4_copy((float*)v[i], tri[i]);
+        setup_triangle(td, tri, rgb);
+        return;
+    }
+
+    // Each plane adds at most one vertex: 3 -> 4 -> 5
+    vec4 poly[3], near[4], both[5];
+    for (int i = 0; i < 3; i++) glm_vec4_copy((float*)v[i], poly[i]);
+    int n = clip_plane(poly, 3, near, 0);
+    n = clip_plane(near, n, both, 1);
+    for (int i = 1; i + 1 < n; i++) {
+        vec4 tri[3];
+        glm_vec4_copy(both[0], tri[0]);
+        glm_vec4_copy(both[i], tri[1]);
+        glm_vec4_copy(both[i + 1], tri[2]);
+        setup_triangle(td, tri, rgb);
+    }
+}
+
+static void setup_phase(int thread) {
+    TRACE_ZONE("raster setup");
+    ThreadData* td = &threadData[thread];
+    td->triCount = 0;
+    td->triangles = td->binned = td->blocksSkipped = 0;
+    td->failed = 0;
+    for (int i = 0; i < tilesX * tilesY; i++) td->bins[i].count = 0;
+
+    // Contiguous instance ranges keep submission order within each thread;
+    // tiles then walk the threads in order, so the result is deterministic.
+    int first = (int)((long)instCount * thread / threadCount);
+    int last  = (int)((long)instCount * (thread + 1) / threadCount);
+    for (int i = first; i < last; i++) {
+        const RasterMesh* m = &meshes[instMesh[i]];
+        if (grow((void**)&td->clip, &td->clipCap, m->vertexCount, sizeof(vec4)) != 0) {
+            td->failed = 1;
+            return;
+        }
+
+        mat4 mvp;
+        glm_mat4_mul(frameViewProj, instModels[i], mvp);
+        for (int v = 0; v < m->vertexCount; v++) {
+            const float* p = &m->vertices[v * m->stride];
+            for (int k = 0; k < 4; k++) {
+                td->clip[v][k] = mvp[0][k] * p[0] + mvp[1][k] * p[1]
+                               + mvp[2][k] * p[2] + mvp[3][k];
+            }
+        }
+        for (int t = 0; t + 2 < m->indexCount; t += 3) {
+            const GLuint* idx = &m->indices[t];
+            emit_triangle(td, td->clip[idx[0]], td->clip[idx[1]], td->clip[idx[2]],
+                          m->colors[idx[0]]);
+        }
+    }
+}
+
+// ---- raster phase -----------------------------------------------------------
+
+#define W 1
+#define KERNEL(name) name##_scalar
+#include "raster_kernel.inc"
+
+#if defined(__SSE2__)
+#define W 4
+#define KERNEL(name) name##_sse
+#include "raster_kernel.inc"
+#endif
+
+#if CPU_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define W 8
+#define KERNEL(name) name##_avx2
+#include "raster_kernel.inc"
+#pragma GCC pop_options
+#endif
+
+// A block row is only 8 pixels, so AVX-512 machines run the AVX2 kernel
+static CpuLevel kernel_level(void) {
+    return cpu_level() > CPU_AVX2 ? CPU_AVX2 : cpu_level();
+}
+
+static void pick_kernel(void) {
+    switch (kernel_level()) {
+#if CPU_TARGET_PRAGMAS
+    case CPU_AVX2: draw_block = draw_block_avx2;   break;
+#endif
+#if defined(__SSE2__)
+    case CPU_SSE:  draw_block = draw_block_sse;    break;
+#endif
+    default:       draw_block = draw_block_scalar; break;
+    }
+}
+
+// Clears one 8x8 block of color and depth.
+static void fill_block(int bx, int by) {
+    for (int row = 0; row < BLOCK; row++) {
+        uint32_t* c = &color[(size_t)(by + row) * pitch + bx];
+        float*    d = &depth[(size_t)(by + row) * pitch + bx];
+        for (int col = 0; col < BLOCK; col++) {
+            c[col] = clearColor;
+            d[col] = 1.0f;
+        }
+    }
+}
+
+static void draw_in_tile(ThreadData* td, const Tri* t, int tileX, int tileY) {
+    int minX = t->minX > tileX ? t->minX : tileX;
+    int minY = t->minY > tileY ? t->minY : tileY;
+    int maxX = t->maxX < tileX + RASTER_TILE - 1 ? t->maxX : tileX + RASTER_TILE - 1;
+    int maxY = t->maxY < tileY + RASTER_TILE - 1 ? t->maxY : tileY + RASTER_TILE - 1;
+    int blocksPerRow = pitch / BLOCK;
+
+    for (int by = minY & ~(BLOCK - 1); by <= maxY; by += BLOCK) {
+        for (int bx = minX & ~(BLOCK - 1); bx <= maxX; bx += BLOCK) {
+            float* bmax = &blockMax[(by / BLOCK) * blocksPerRow + bx / BLOCK];
+            if (t->zmin >= *bmax) {
+                // Every pixel in the block is already nearer
+                td->blocksSkipped++;
+                continue;
+            }
+
+            // Outside one edge at all four pixel-center corners?
+            int outside = 0;
+            for (int i = 0; i < 3 && !outside; i++) {
+                float cx = t->a[i] >= 0.0f ? bx + BLOCK - 0.5f : bx + 0.5f;
+                float cy = t->b[i] >= 0.0f ? by + BLOCK - 0.5f : by + 0.5f;
+                outside = t->a[i] * cx + t->b[i] * cy + t->c[i] < 0.0f;
+            }
+            if (outside) continue;
+
+            uint8_t* state = &blockState[(by / BLOCK) * blocksPerRow + bx / BLOCK];
+            if (!(*state & BLOCK_TOUCHED)) {
+                fill_block(bx, by);
+                *state = BLOCK_TOUCHED | BLOCK_DIRTY;
+            }
+            // Small triangles only cover a few rows of the block
+            int y0 = minY > by ? minY : by;
+            int y1 = maxY < by + BLOCK - 1 ? maxY : by + BLOCK - 1;
+            if (!draw_block(t, bx, y0, y1)) continue;
+
+            float m = 0.0f;
+            for (int row = 0; row < BLOCK; row++) {
+                const float* d = &depth[(size_t)(by + row) * pitch + bx];
+                for (int col = 0; col < BLOCK; col++) m = d[col] > m ? d[col] : m;
+            }
+            *bmax = m;
+        }
+    }
+}
+
+// Starts a tile: the depth hierarchy says "empty" and nothing is touched.
+static void begin_tile(int tileX, int tileY) {
+    int blocksPerRow = pitch / BLOCK;
+    for (int by = tileY / BLOCK; by < (tileY + RASTER_TILE) / BLOCK; by++) {
+        for (int bx = tileX / BLOCK; bx < (tileX + RASTER_TILE) / BLOCK; bx++) {
+            blockMax[by * blocksPerRow + bx] = 1.0f;
+            blockState[by * blocksPerRow + bx] &= ~BLOCK_TOUCHED;
+        }
+    }
+}
+
+// Ends a tile: blocks left over from last frame get the clear color.
+static void end_tile(int tileX, int tileY) {
+    int blocksPerRow = pitch / BLOCK;
+    for (int by = tileY / BLOCK; by < (tileY + RASTER_TILE) / BLOCK; by++) {
+        for (int bx = tileX / BLOCK; bx < (tileX + RASTER_TILE) / BLOCK; bx++) {
+            uint8_t* state = &blockState[by * blocksPerRow + bx];
+            if (*state == BLOCK_DIRTY) {
+                fill_block(bx * BLOCK, by * BLOCK);
+                *state = 0;
+            }
+        }
+    }
+}
+
+static void raster_phase(int thread) {
+    TRACE_ZONE("raster tiles");
+    ThreadData* self = &threadData[thread];
+    for (;;) {
+        int tile = SDL_AtomicAdd(&nextTile, 1);
+        if (tile >= tilesX * tilesY) break;
+        int tileX = (tile % tilesX) * RASTER_TILE;
+        int tileY = (tile / tilesX) * RASTER_TILE;
+
+        begin_tile(tileX, tileY);
+        for (int t = 0; t < threadCount; t++) {
+            const ThreadData* td = &threadData[t];
+            const Bin* bin = &td->bins[tile];
+            for (int i = 0; i < bin->count; i++) {
+                draw_in_tile(self, &td->tris[bin->items[i]], tileX, tileY);
+            }
+        }
+        end_tile(tileX, tileY);
+    }
+}
+
+void raster_flush(mat4 viewProj) {
+    if (!active) return;
+    glm_mat4_copy(viewProj, frameViewProj);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    run_phase(setup_phase);
+    stats.setupMs = elapsed_ms(start);
+
+    start = SDL_GetPerformanceCounter();
+    SDL_AtomicSet(&nextTile, 0);
+    run_phase(raster_phase);
+    stats.rasterMs = elapsed_ms(start);
+
+    stats.threads = threadCount;
+    stats.instances = instCount;
+    stats.triangles = stats.binned = stats.blocksSkipped = 0;
+    for (int t = 0; t < threadCount; t++) {
+        stats.triangles     += threadData[t].triangles;
+        stats.binned        += threadData[t].binned;
+        stats.blocksSkipped += threadData[t].blocksSkipped;
+        if (threadData[t].failed) {
+            fprintf(stderr, "raster: out of memory, frame is incomplete\n");
+        }
+    }
+}
+
+// ---- output -----------------------------------------------------------------
+
+const uint32_t* raster_pixels(int* w, int* h, int* p) {
+    if (w) *w = width;
+    if (h) *h = height;
+    if (p) *p = pitch;
+    return color;
+}
+
+int raster_present(SDL_Window* window) {
+    SDL_Surface* target = SDL_GetWindowSurface(window);
+    if (!target || !frontSurface) return -1;
+    // Converts to the window's pixel format if it is not ARGB8888
+    if (SDL_BlitSurface(frontSurface, NULL, target, NULL) != 0) return -1;
+    return SDL_UpdateWindowSurface(window);
+}
+
+const char* raster_kernel_name(void) {
+    return cpu_level_name(kernel_level());
+}
+
+RasterStats raster_stats(void) {
+    return stats;
+}
@@ -0,0 +1,68 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include "../shape/mesh.h"
+
+// ------------------------------------------------------------------
+// Software rasterizer (raster/raster.c):
+// a CPU backend for hosts without a usable GL driver. It takes the
+// same meshes as the GL path (vec3 position + vec3 flat color per
+// vertex) and the same per-instance model matrices, and renders into
+// an ARGB8888 color buffer plus a float depth buffer.
+//
+// raster_flush() runs two parallel phases: every thread transforms,
+// clips and sets up its share of the instances and bins the
+// triangles into RASTER_TILE x RASTER_TILE screen tiles; then the
+// threads take whole tiles and rasterize them with SIMD edge
+// functions, skipping 8x8 blocks whose stored depth already beats
+// the triangle (hierarchical depth).
+// ------------------------------------------------------------------
+#define RASTER_TILE        64
+#define RASTER_MAX_THREADS 32
+#define RASTER_MAX_MESHES  64
+
+typedef struct {
+    int      threads;
+    unsigned instances;
+    unsigned triangles;   // after clipping, culling and setup
+    unsigned binned;      // triangle/tile pairs
+    unsigned blocksSkipped;  // 8x8 blocks rejected by the depth hierarchy
+    double   setupMs;     // transform + clip + bin
+    double   rasterMs;    // tiles
+} RasterStats;
+
+// `threads` <= 0 uses one per CPU.
+int  raster_init(int width, int height, int threads);
+void raster_destroy(void);
+// 1 between raster_init() and raster_destroy(); shapes use it to pick
+// the backend they register meshes and submit instances with.
+int  raster_active(void);
+// Returns -1 if the new targets cannot be allocated; the old ones and
+// their size are kept.
+int  raster_resize(int width, int height);
+
+// Copies a built mesh (stride >= 6, color at floats 3..5). Returns its
+// id for raster_submit(), or -1.
+int  raster_add_mesh(const Mesh* mesh);
+
+void raster_clear_color(float r, float g, float b);
+
+// Queue `count` instances of `mesh`, one model matrix each, between
+// raster_begin() and raster_flush().
+void raster_begin(void);
+void raster_submit(int mesh, const mat4* models, int count);
+void raster_flush(mat4 viewProj);
+
+// The finished frame, row-major ARGB8888, `pitch` pixels per row.
+const uint32_t* raster_pixels(int* width, int* height, int* pitch);
+// Copies the frame to the window surface (a window created without
+// SDL_WINDOW_OPENGL) and shows it.
+int  raster_present(SDL_Window* window);
+
+const char* raster_kernel_name(void);
+RasterStats raster_stats(void);
+
+#endif // RASTER_H
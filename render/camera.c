@@ -0,0 +1,85 @@
+// render/camera.c
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include <string.h>
+#include "camera.h"
+
+#define DIRTY_VIEW 0x1
+#define DIRTY_PROJ 0x2
+
+static Camera camera;
+static vec3  eye, target, up;
+static float fovy, nearZ, farZ;
+static int   dirty = 0;
+static int   pendingWidth, pendingHeight;   // last size asked for
+static int   settleWidth, settleHeight;     // size framebuffer resources have
+static Uint32 lastResize = 0;
+
+void camera_init(int width, int height) {
+    memset(&camera, 0, sizeof(camera));
+    glm_vec3_copy((vec3){0.0f, 0.0f, 5.0f}, eye);
+    glm_vec3_zero(target);
+    glm_vec3_copy((vec3){0.0f, 1.0f, 0.0f}, up);
+    fovy = glm_rad(45.0f);
+    nearZ = 0.1f;
+    farZ = 100.0f;
+    camera.width = pendingWidth = settleWidth = width;
+    camera.height = pendingHeight = settleHeight = height;
+    dirty = DIRTY_VIEW | DIRTY_PROJ;
+}
+
+void camera_look_at(vec3 newEye, vec3 newTarget, vec3 newUp) {
+    if (glm_vec3_eqv(eye, newEye) && glm_vec3_eqv(target, newTarget) && glm_vec3_eqv(up, newUp)) {
+        return;
+    }
+    glm_vec3_copy(newEye, eye);
+    glm_vec3_copy(newTarget, target);
+    glm_vec3_copy(newUp, up);
+    dirty |= DIRTY_VIEW;
+}
+
+void camera_perspective(float newFovy, float newNear, float newFar) {
+    if (newFovy == fovy && newNear == nearZ && newFar == farZ) return;
+    fovy = newFovy;
+    nearZ = newNear;
+    farZ = newFar;
+    dirty |= DIRTY_PROJ;
+}
+
+void camera_resize(int width, int height) {
+    if (width <= 0 || height <= 0) return;   // minimized
+    pendingWidth = width;
+    pendingHeight = height;
+    lastResize = SDL_GetTicks();
+}
+
+int camera_update(void) {
+    int changes = 0;
+    if (pendingWidth != camera.width || pendingHeight != camera.height) {
+        camera.width = pendingWidth;
+        camera.height = pendingHeight;
+        dirty |= DIRTY_PROJ;
+        changes |= CAMERA_RESIZED;
+    }
+    if ((pendingWidth != settleWidth || pendingHeight != settleHeight)
+        && SDL_GetTicks() - lastResize >= CAMERA_RESIZE_SETTLE_MS) {
+        settleWidth = pendingWidth;
+        settleHeight = pendingHeight;
+        changes |= CAMERA_SETTLED;
+    }
+    if (!dirty) return changes;
+
+    if (dirty & DIRTY_VIEW) glm_lookat(eye, target, up, camera.view);
+    if (dirty & DIRTY_PROJ) {
+        glm_perspective(fovy, (float)camera.width / (float)camera.height, nearZ, farZ,
+                        camera.proj);
+    }
+    glm_mat4_mul(camera.proj, camera.view, camera.viewProj);
+    glm_frustum_planes(camera.viewProj, camera.planes);
+    dirty = 0;
+    return changes | CAMERA_MOVED;
+}
+
+const Camera* camera_current(void) {
+    return &camera;
+}
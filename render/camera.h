@@ -0,0 +1,51 @@
+#ifndef RENDER_CAMERA_H
+#define RENDER_CAMERA_H
+
+#include <cglm/cglm.h>
+
+// ------------------------------------------------------------------
+// Camera (render/camera.c):
+// owns the view and projection and what is derived from them (their
+// product and its frustum planes), and recomputes them only when the
+// eye, the lens or the drawable size changed, so a frame where
+// nothing moved costs nothing beyond one call to camera_update().
+//
+// Sizes are drawable pixels (SDL_GL_GetDrawableSize() on HiDPI
+// displays), not window coordinates. A resize reaches the projection
+// and the viewport on the next frame, while resources sized to the
+// framebuffer wait until no resize came for CAMERA_RESIZE_SETTLE_MS,
+// so dragging a window edge does not reallocate them every frame.
+// ------------------------------------------------------------------
+#define CAMERA_RESIZE_SETTLE_MS 150
+
+// camera_update() results
+#define CAMERA_MOVED    0x1   // view and/or projection changed
+#define CAMERA_RESIZED  0x2   // drawable size changed: set the viewport
+#define CAMERA_SETTLED  0x4   // resizing stopped: resize framebuffer resources
+
+typedef struct {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+    vec4 planes[6];         // of viewProj, normalized, inward normals
+    int  width, height;     // drawable size in pixels
+} Camera;
+
+// Starts with the eye at (0, 0, 5) looking at the origin, a 45° lens
+// and depth from 0.1 to 100.
+void camera_init(int width, int height);
+
+// Both only mark the camera dirty if something differs.
+void camera_look_at(vec3 eye, vec3 target, vec3 up);
+void camera_perspective(float fovy, float nearZ, float farZ);   // fovy in radians
+
+// A new drawable size, e.g. on SDL_WINDOWEVENT_SIZE_CHANGED.
+void camera_resize(int width, int height);
+
+// Once per frame, before anything reads the camera. Applies what
+// changed and returns the CAMERA_* bits for it (0 most frames).
+int  camera_update(void);
+
+const Camera* camera_current(void);
+
+#endif // RENDER_CAMERA_H
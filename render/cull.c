@@ -0,0 +1,203 @@
+// render/cull.c
+#include <SDL2/SDL.h>
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cull.h"
+#include "../bench/trace.h"
+#include "../core/cpu.h"
+
+// -----------------------------------------------------------------------------
+// A volume is outside the frustum if, for some plane (n, d),
+//
+//     dot(n, center) + d < -r
+//
+// where r is the sphere radius, or |n.x|*ex + |n.y|*ey + |n.z|*ez for a box
+// (its projected half-size onto the plane normal). The SoA layout lets one
+// iteration load the centers and extents of W volumes with plain vector
+// loads, test all six planes lane-wise, and turn the surviving lanes into
+// indices with a movemask. A group stops testing planes as soon as every
+// lane is out. Whatever does not fill a whole group runs the scalar loop.
+//
+// The kernel is built for every level in core/cpu.h (W = 1, 4, 8 and 16
+// lanes) and cull_run_range() calls the one cpu_level() picked.
+// -----------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define ARRAY_ALIGN 32   // enough for aligned AVX loads
+
+// Updated by every thread running cull_run_range()
+static struct {
+    atomic_uint   tested, visible;
+    atomic_ullong ticks;
+} current;
+static CullStats last;
+
+// ---- storage ----------------------------------------------------------------
+
+// The six SoA arrays, so allocation code can loop over them.
+static void arrays(CullSet* set, float** out[6]) {
+    out[0] = &set->x;  out[1] = &set->y;  out[2] = &set->z;
+    out[3] = &set->ex; out[4] = &set->ey; out[5] = &set->ez;
+}
+
+void cull_set_init(CullSet* set, CullKind kind) {
+    memset(set, 0, sizeof(*set));
+    set->kind = kind;
+}
+
+void cull_set_free(CullSet* set) {
+    float** a[6];
+    arrays(set, a);
+    for (int i = 0; i < 6; i++) {
+        free(*a[i]);
+        *a[i] = NULL;
+    }
+    set->count = set->capacity = 0;
+}
+
+void cull_set_clear(CullSet* set) {
+    set->count = 0;
+}
+
+static int grow(CullSet* set) {
+    if (set->count < set->capacity) return 0;
+    int cap = set->capacity ? set->capacity * 2 : 64;   // stays a multiple of W
+    size_t bytes = sizeof(float) * cap;
+
+    float** a[6];
+    arrays(set, a);
+    float* grown[6] = {0};
+    for (int i = 0; i < 6; i++) {
+        grown[i] = aligned_alloc(ARRAY_ALIGN, bytes);
+        if (!grown[i]) {
+            for (int j = 0; j < i; j++) free(grown[j]);
+            return -1;
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        if (*a[i]) memcpy(grown[i], *a[i], sizeof(float) * set->count);
+        free(*a[i]);
+        *a[i] = grown[i];
+    }
+    set->capacity = cap;
+    return 0;
+}
+
+static int add(CullSet* set, float x, float y, float z, float ex, float ey, float ez) {
+    if (grow(set) != 0) return -1;
+    int i = set->count++;
+    set->x[i] = x;   set->y[i] = y;   set->z[i] = z;
+    set->ex[i] = ex; set->ey[i] = ey; set->ez[i] = ez;
+    return i;
+}
+
+int cull_set_add_sphere(CullSet* set, const vec3 center, float radius) {
+    return add(set, center[0], center[1], center[2], radius, 0.0f, 0.0f);
+}
+
+int cull_set_add_box(CullSet* set, const vec3 min, const vec3 max) {
+    return add(set,
+               (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f,
+               (max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f);
+}
+
+// ---- test -------------------------------------------------------------------
+
+static int inside_scalar(const CullSet* set, vec4 planes[6], int i) {
+    int boxes = set->kind == CULL_BOXES;
+    for (int p = 0; p < 6; p++) {
+        const float* n = planes[p];
+        float d = n[0] * set->x[i] + n[1] * set->y[i] + n[2] * set->z[i] + n[3];
+        float r = boxes ? fabsf(n[0]) * set->ex[i] + fabsf(n[1]) * set->ey[i]
+                          + fabsf(n[2]) * set->ez[i]
+                        : set->ex[i];
+        if (d + r < 0.0f) return 0;
+    }
+    return 1;
+}
+
+#define W 1
+#define KERNEL(name) name##_scalar
+#include "cull_kernel.inc"
+
+#if defined(__SSE2__)
+#define W 4
+#define KERNEL(name) name##_sse
+#include "cull_kernel.inc"
+#endif
+
+#if CPU_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define W 8
+#define KERNEL(name) name##_avx2
+#include "cull_kernel.inc"
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define W 16
+#define KERNEL(name) name##_avx512
+#include "cull_kernel.inc"
+#pragma GCC pop_options
+#endif
+
+typedef int (*RangeFn)(const CullSet* set, vec4 planes[6], int first, int count, int* visible);
+
+static RangeFn kernel(void) {
+    switch (cpu_level()) {
+#if CPU_TARGET_PRAGMAS
+    case CPU_AVX512: return cull_range_avx512;
+    case CPU_AVX2:   return cull_range_avx2;
+#endif
+#if defined(__SSE2__)
+    case CPU_SSE:    return cull_range_sse;
+#endif
+    default:         return cull_range_scalar;
+    }
+}
+
+int cull_run(const CullSet* set, vec4 planes[6], int* visible) {
+    return cull_run_range(set, planes, 0, set->count, visible);
+}
+
+int cull_run_range(const CullSet* set, vec4 planes[6], int first, int count, int* visible) {
+    TRACE_ZONE("cull");
+    Uint64 start = SDL_GetPerformanceCounter();
+    int n = kernel()(set, planes, first, count, visible);
+
+    atomic_fetch_add_explicit(&current.tested, (unsigned)count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&current.visible, (unsigned)n, memory_order_relaxed);
+    atomic_fetch_add_explicit(&current.ticks, SDL_GetPerformanceCounter() - start,
+                              memory_order_relaxed);
+    return n;
+}
+
+const char* cull_kernel_name(void) {
+    return cpu_level_name(cpu_level());
+}
+
+void cull_end_frame(void) {
+    last.tested  = atomic_exchange(&current.tested, 0);
+    last.visible = atomic_exchange(&current.visible, 0);
+    last.ms = (double)atomic_exchange(&current.ticks, 0) * 1000.0
+            / (double)SDL_GetPerformanceFrequency();
+}
+
+CullStats cull_stats(void) {
+    return last;
+}
+
+void cull_report(FILE* out) {
+    fprintf(out, "cull: %u of %u visible (%.0f%%) in %.3f ms last frame, %s kernel\n",
+            last.visible, last.tested,
+            last.tested ? 100.0 * last.visible / last.tested : 0.0, last.ms,
+            cull_kernel_name());
+}
@@ -0,0 +1,67 @@
+#ifndef CULL_H
+#define CULL_H
+
+#include <cglm/cglm.h>
+#include <stdio.h>
+
+// ------------------------------------------------------------------
+// Frustum culling (render/cull.c):
+// bounding volumes are kept in structure-of-arrays form and tested
+// against the six planes of a view-projection matrix, 16, 8 or 4 at
+// a time with AVX-512, AVX2 or SSE (whichever core/cpu.h picked),
+// producing a compact list of the indices that may be visible.
+// ------------------------------------------------------------------
+
+typedef enum {
+    CULL_SPHERES,   // center + radius (rotation invariant)
+    CULL_BOXES,     // world-space AABB as center + half extents
+} CullKind;
+
+typedef struct {
+    CullKind kind;
+    float* x;       // centers
+    float* y;
+    float* z;
+    float* ex;      // sphere radius, or AABB half extent on x
+    float* ey;      // AABB half extents on y / z (unused for spheres)
+    float* ez;
+    int    count;
+    int    capacity;
+} CullSet;
+
+typedef struct {
+    unsigned tested;     // volumes tested
+    unsigned visible;    // volumes that passed
+    double   ms;         // CPU time spent culling, summed over threads
+} CullStats;
+
+void cull_set_init(CullSet* set, CullKind kind);
+void cull_set_free(CullSet* set);
+// Drops every volume but keeps the storage.
+void cull_set_clear(CullSet* set);
+// Append a volume; return its index, or -1 if out of memory.
+int  cull_set_add_sphere(CullSet* set, const vec3 center, float radius);
+int  cull_set_add_box(CullSet* set, const vec3 min, const vec3 max);
+
+// Writes the index of every volume that intersects the frustum to
+// `visible` (room for set->count entries) and returns how many.
+// `planes` are normalized with inward normals, as glm_frustum_planes()
+// extracts them from a view-projection matrix.
+int  cull_run(const CullSet* set, vec4 planes[6], int* visible);
+// Same for volumes [first, first + count) only, so several threads can
+// cull parts of one set: `first` must be a multiple of CULL_GROUP and
+// `visible` needs room for `count` entries.
+#define CULL_GROUP 8
+int  cull_run_range(const CullSet* set, vec4 planes[6], int first, int count, int* visible);
+
+// Name of the kernel in use ("avx512", "avx2", "sse" or "scalar").
+const char* cull_kernel_name(void);
+
+// Ends the frame: the counters restart and cull_stats() returns the
+// totals of the frame that just finished.
+void cull_end_frame(void);
+CullStats cull_stats(void);
+// One line with cull_stats().
+void cull_report(FILE* out);
+
+#endif // CULL_H
@@ -0,0 +1,185 @@
+// render/gpuprof.c
+#include <glad/glad.h>
+#include <stdio.h>
+#include <string.h>
+#include "gpuprof.h"
+
+#define NAME_LENGTH 32
+
+typedef struct {
+    char   name[NAME_LENGTH];
+    int    depth;                     // nesting level when last opened
+    double history[GPUPROF_WINDOW];   // per-frame totals, ring
+    int    historyCount, historyAt;
+    double frameMs;                   // total of the frame being collected
+    int    seen;
+} Scope;
+
+typedef struct {
+    int scope;
+    int ended;
+} Event;
+
+typedef struct {
+    Event events[GPUPROF_MAX_EVENTS];
+    int   count;
+    int   pending;   // issued but not collected yet
+} FrameSlot;
+
+static int active = 0;
+static GLuint queries[GPUPROF_FRAMES][GPUPROF_MAX_EVENTS][2];
+static FrameSlot slots[GPUPROF_FRAMES];
+static int slot = 0;
+static int depth = 0;
+
+static Scope scopes[GPUPROF_MAX_SCOPES];
+static int scopeCount = 0;
+static int order[GPUPROF_MAX_SCOPES];   // scopes of the last collected frame, as opened
+static int orderCount = 0;
+static unsigned dropped = 0;            // frames whose results were not ready
+
+int gpuprof_init(void) {
+    if (active) return 0;
+    // Timestamps are core in 3.3, but a driver may still report no counter
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (bits == 0) {
+        fprintf(stderr, "gpuprof: no GL_TIMESTAMP counter, GPU profiling disabled\n");
+        return -1;
+    }
+    glGenQueries(GPUPROF_FRAMES * GPUPROF_MAX_EVENTS * 2, &queries[0][0][0]);
+    memset(slots, 0, sizeof(slots));
+    slot = 0;
+    dropped = 0;
+    depth = 0;
+    active = 1;
+    return 0;
+}
+
+void gpuprof_destroy(void) {
+    if (active) {
+        glDeleteQueries(GPUPROF_FRAMES * GPUPROF_MAX_EVENTS * 2, &queries[0][0][0]);
+    }
+    active = 0;
+}
+
+int gpuprof_active(void) {
+    return active;
+}
+
+int gpuprof_scope(const char* name) {
+    for (int i = 0; i < scopeCount; i++) {
+        if (strncmp(scopes[i].name, name, NAME_LENGTH - 1) == 0) return i;
+    }
+    if (scopeCount == GPUPROF_MAX_SCOPES) return -1;
+    Scope* s = &scopes[scopeCount];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, NAME_LENGTH, "%s", name);
+    return scopeCount++;
+}
+
+// Sums the scopes of a finished frame and pushes the totals into the
+// history of every scope that ran in it. A frame the GPU has not
+// finished yet is dropped rather than waited for.
+static void collect(FrameSlot* f, GLuint (*q)[2]) {
+    if (!f->pending) {
+        f->count = 0;   // a frame that was never ended
+        return;
+    }
+    for (int i = 0; i < f->count; i++) {
+        if (!f->events[i].ended) continue;
+        // A timestamp is written after every command before it, so the
+        // start of the scope is ready as well
+        GLuint ready = GL_FALSE;
+        glGetQueryObjectuiv(q[i][1], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready) {
+            dropped++;
+            f->count = 0;
+            f->pending = 0;
+            return;
+        }
+    }
+    orderCount = 0;
+    for (int i = 0; i < f->count; i++) {
+        if (!f->events[i].ended) continue;
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(q[i][0], GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(q[i][1], GL_QUERY_RESULT, &t1);
+        Scope* s = &scopes[f->events[i].scope];
+        s->frameMs += t1 > t0 ? (double)(t1 - t0) / 1.0e6 : 0.0;
+        if (!s->seen) order[orderCount++] = f->events[i].scope;
+        s->seen = 1;
+    }
+    for (int i = 0; i < scopeCount; i++) {
+        Scope* s = &scopes[i];
+        if (!s->seen) continue;
+        s->history[s->historyAt] = s->frameMs;
+        s->historyAt = (s->historyAt + 1) % GPUPROF_WINDOW;
+        if (s->historyCount < GPUPROF_WINDOW) s->historyCount++;
+        s->frameMs = 0.0;
+        s->seen = 0;
+    }
+    f->count = 0;
+    f->pending = 0;
+}
+
+void gpuprof_begin_frame(void) {
+    if (!active) return;
+    slot = (slot + 1) % GPUPROF_FRAMES;
+    collect(&slots[slot], queries[slot]);
+    depth = 0;
+}
+
+void gpuprof_end_frame(void) {
+    if (!active) return;
+    slots[slot].pending = slots[slot].count > 0;
+}
+
+int gpuprof_begin(int scope) {
+    if (!active || scope < 0) return -1;
+    FrameSlot* f = &slots[slot];
+    if (f->count == GPUPROF_MAX_EVENTS) return -1;
+    int e = f->count++;
+    f->events[e] = (Event){ .scope = scope, .ended = 0 };
+    scopes[scope].depth = depth++;
+    glQueryCounter(queries[slot][e][0], GL_TIMESTAMP);
+    return e;
+}
+
+void gpuprof_end(int event) {
+    if (!active || event < 0) return;
+    glQueryCounter(queries[slot][event][1], GL_TIMESTAMP);
+    slots[slot].events[event].ended = 1;
+    depth--;
+}
+
+int gpuprof_scope_count(void) {
+    return scopeCount;
+}
+
+GpuScopeStats gpuprof_stats(int scope) {
+    const Scope* s = &scopes[scope];
+    GpuScopeStats out = { .name = s->name };
+    if (s->historyCount == 0) return out;
+    double sum = 0.0;
+    for (int i = 0; i < s->historyCount; i++) {
+        sum += s->history[i];
+        if (s->history[i] > out.maxMs) out.maxMs = s->history[i];
+    }
+    out.avgMs = sum / s->historyCount;
+    out.lastMs = s->history[(s->historyAt + GPUPROF_WINDOW - 1) % GPUPROF_WINDOW];
+    return out;
+}
+
+void gpuprof_report(FILE* out) {
+    if (!active) return;
+    fprintf(out, "gpu: %-24s %9s %9s %9s\n", "scope (ms)", "last", "avg", "max");
+    for (int i = 0; i < orderCount; i++) {
+        const Scope* scope = &scopes[order[i]];
+        GpuScopeStats s = gpuprof_stats(order[i]);
+        fprintf(out, "gpu: %*s%-*s %9.3f %9.3f %9.3f\n",
+                scope->depth * 2, "", 24 - scope->depth * 2, s.name,
+                s.lastMs, s.avgMs, s.maxMs);
+    }
+    if (dropped) fprintf(out, "gpu: %u frames dropped, results not ready in time\n", dropped);
+}
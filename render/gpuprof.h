@@ -0,0 +1,57 @@
+#ifndef GPUPROF_H
+#define GPUPROF_H
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------
+// GPU profiler (render/gpuprof.c):
+// named scopes bracketed by GL_TIMESTAMP queries, so scopes may nest
+// and overlap with anything else measuring GL_TIME_ELAPSED. Queries
+// come from a pool of GPUPROF_FRAMES frames and a frame's results are
+// read back when its slot comes round again, long after the GPU got
+// there. Results are only read once available, so the pipeline never
+// stalls on them: a frame still unfinished by then (a driver queuing
+// more than GPUPROF_FRAMES frames) is dropped and counted instead.
+// Each scope keeps its per-frame total over the last GPUPROF_WINDOW
+// frames.
+//
+// Every call but gpuprof_scope() is a no-op until gpuprof_init()
+// succeeds, so scopes can stay in the code of backends without a GL
+// context. Scope ids stay valid across init/destroy.
+// ------------------------------------------------------------------
+#define GPUPROF_FRAMES     4
+#define GPUPROF_MAX_SCOPES 32
+#define GPUPROF_MAX_EVENTS 64    // scope instances per frame
+#define GPUPROF_WINDOW     60
+
+typedef struct {
+    const char* name;
+    double lastMs;   // newest frame with results
+    double avgMs;    // over the last GPUPROF_WINDOW frames
+    double maxMs;    // same window
+} GpuScopeStats;
+
+// Returns 0, or -1 when the driver has no timestamp counter.
+int  gpuprof_init(void);
+void gpuprof_destroy(void);
+int  gpuprof_active(void);
+
+// Interns `name` (copied) and returns its id, the same id every time.
+int  gpuprof_scope(const char* name);
+
+// Bracket every frame; begin collects the oldest frame in the pool.
+void gpuprof_begin_frame(void);
+void gpuprof_end_frame(void);
+
+// Returns a handle for gpuprof_end(), or -1 (inactive, or the frame
+// already holds GPUPROF_MAX_EVENTS scopes).
+int  gpuprof_begin(int scope);
+void gpuprof_end(int event);
+
+int           gpuprof_scope_count(void);
+GpuScopeStats gpuprof_stats(int scope);
+// One line per scope of the newest frame with results, in the order
+// they were opened and indented under their parent.
+void          gpuprof_report(FILE* out);
+
+#endif // GPUPROF_H
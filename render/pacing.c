@@ -0,0 +1,114 @@
+// render/pacing.c
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include "pacing.h"
+
+// Bounds of the spin margin: the OS timer is never trusted to better than
+// MIN_SPIN_MS, and a single very late wake-up costs at most MAX_SPIN_MS
+#define MIN_SPIN_MS 0.25
+#define MAX_SPIN_MS 4.0
+
+static PacingVsync vsyncMode = PACING_VSYNC_OFF;
+static int    swapping = 0;
+static double ticksPerMs;
+static Uint64 period = 0;   // limiter period in counter ticks, 0 = no limit
+static Uint64 next = 0;     // earliest present of the coming frame
+static double spinMs = 1.0;
+static double sleptMs, spunMs;
+
+// Present-to-present intervals (ms), Welford's running mean/variance
+static Uint64 lastPresent = 0;
+static long   intervals;
+static double mean, m2, worst;
+
+static double ms_between(Uint64 start, Uint64 end) {
+    return (double)(end - start) / ticksPerMs;
+}
+
+PacingVsync pacing_init(PacingVsync vsync, double fps, int swapControl) {
+    ticksPerMs = (double)SDL_GetPerformanceFrequency() / 1000.0;
+    period = fps > 0.0 ? (Uint64)(ticksPerMs * 1000.0 / fps) : 0;
+    next = lastPresent = 0;
+    intervals = 0;
+    mean = m2 = worst = sleptMs = spunMs = 0.0;
+    swapping = swapControl;
+    vsyncMode = PACING_VSYNC_OFF;
+    if (!swapControl) return vsyncMode;
+
+    if (SDL_GL_SetSwapInterval(vsync) != 0 && vsync == PACING_VSYNC_ADAPTIVE) {
+        fprintf(stderr, "pacing: no adaptive vsync (%s), using vsync\n", SDL_GetError());
+        vsync = PACING_VSYNC_ON;
+        SDL_GL_SetSwapInterval(vsync);
+    }
+    vsyncMode = (PacingVsync)SDL_GL_GetSwapInterval();
+    return vsyncMode;
+}
+
+void pacing_wait(void) {
+    if (!period) return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (next == 0) next = now;
+
+    if (now < next) {
+        // Coarse: sleep all but the spin margin, and learn how late the
+        // OS wakes us up
+        double sleepMs = ms_between(now, next) - spinMs;
+        if (sleepMs >= 1.0) {
+            Uint32 asked = (Uint32)sleepMs;
+            SDL_Delay(asked);
+            Uint64 woke = SDL_GetPerformanceCounter();
+            double slept = ms_between(now, woke);
+            sleptMs += slept;
+            // Jumps up to a bad wake-up at once, decays slowly afterwards
+            double late = slept - asked;
+            if (late > spinMs) spinMs = fmin(late, MAX_SPIN_MS);
+            else               spinMs = fmax(spinMs * 0.99 + late * 0.01, MIN_SPIN_MS);
+            now = woke;
+        }
+        // Fine: spin to the deadline
+        Uint64 spinStart = now;
+        while (now < next) now = SDL_GetPerformanceCounter();
+        spunMs += ms_between(spinStart, now);
+    } else if (now - next > period) {
+        // More than a frame late: start over rather than rush frames out
+        // to catch up
+        next = now;
+    }
+    next += period;
+}
+
+void pacing_presented(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (lastPresent) {
+        double ms = ms_between(lastPresent, now);
+        double delta = ms - mean;
+        intervals++;
+        mean += delta / (double)intervals;
+        m2 += delta * (ms - mean);
+        if (ms > worst) worst = ms;
+    }
+    lastPresent = now;
+}
+
+void pacing_idle(void) {
+    lastPresent = 0;
+    next = 0;
+}
+
+void pacing_report(FILE* out) {
+    static const char* vsyncNames[] = { "adaptive", "off", "on" };
+    char limit[32] = "none";
+    if (period) snprintf(limit, sizeof(limit), "%.1f fps", 1000.0 * ticksPerMs / (double)period);
+
+    fprintf(out, "pacing: vsync %s, limit %s\n",
+            swapping ? vsyncNames[vsyncMode + 1] : "n/a", limit);
+    if (intervals == 0) return;
+    fprintf(out, "  %ld intervals, mean %.2f ms (%.1f fps), jitter %.3f ms (stddev), worst %.2f ms\n",
+            intervals, mean, 1000.0 / mean,
+            intervals > 1 ? sqrt(m2 / (double)(intervals - 1)) : 0.0, worst);
+    if (period) {
+        fprintf(out, "  limiter: %.0f ms asleep, %.0f ms spinning (margin %.2f ms)\n",
+                sleptMs, spunMs, spinMs);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef RENDER_PACING_H
+#define RENDER_PACING_H
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------
+// Frame pacing (render/pacing.c):
+// sets the swap interval explicitly (vsync off, on, or adaptive: sync
+// when on time, tear rather than wait a whole refresh when late) and
+// can cap the frame rate. The limiter sleeps until shortly before the
+// frame's deadline and spins on the performance counter (monotonic)
+// for the rest; the spin margin follows how late the OS timer wakes
+// up, so it only burns as much CPU as that timer needs. The time between
+// consecutive presents is tracked to report the rate and its jitter.
+// ------------------------------------------------------------------
+
+// Values are the SDL_GL_SetSwapInterval() arguments
+typedef enum {
+    PACING_VSYNC_ADAPTIVE = -1,
+    PACING_VSYNC_OFF      = 0,
+    PACING_VSYNC_ON       = 1,
+} PacingVsync;
+
+// `swapControl` is 0 when frames are not presented with
+// SDL_GL_SwapWindow() (headless, software), which leaves the swap
+// interval alone. `fps` <= 0 means no limit. Returns the vsync mode
+// in effect (adaptive falls back to on where unsupported).
+PacingVsync pacing_init(PacingVsync vsync, double fps, int swapControl);
+
+// Right before presenting: waits for the frame's slot if limited.
+void pacing_wait(void);
+// Right after presenting.
+void pacing_presented(void);
+// The loop stopped presenting for a while (idle): the next interval
+// is not a frame time, and the limiter starts over.
+void pacing_idle(void);
+
+void pacing_report(FILE* out);
+
+#endif // RENDER_PACING_H
@@ -0,0 +1,150 @@
+// render/state.c
+#include <glad/glad.h>
+#include <string.h>
+#include "state.h"
+
+// -----------------------------------------------------------------------------
+// Shadow copy of the GL state we touch every frame.
+//
+// Every slot starts out "unknown" so the first call of each kind always
+// reaches the driver; after that a call is only issued when the requested
+// value differs from the shadowed one. Uniforms need no shadowing: every
+// program reads them from the Frame block (render/uniforms.h).
+// -----------------------------------------------------------------------------
+
+#define BUFFER_TARGETS   6
+#define UNIFORM_BINDINGS 16
+
+typedef struct {
+    GLuint value;
+    int    known;
+} Slot;
+
+typedef struct {
+    GLuint     buffer;
+    GLintptr   offset;
+    GLsizeiptr size;
+    int        known;
+} RangeSlot;
+
+static const GLenum bufferTargets[BUFFER_TARGETS] = {
+    GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+    GL_DRAW_INDIRECT_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_PACK_BUFFER,
+};
+
+static const GLenum capabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE };
+#define CAPABILITIES (int)(sizeof(capabilities) / sizeof(capabilities[0]))
+
+static Slot program;
+static Slot vertexArray;
+static Slot buffers[BUFFER_TARGETS];
+static Slot caps[CAPABILITIES];
+static RangeSlot uniformRanges[UNIFORM_BINDINGS];
+
+static StateStats current, last;
+
+// Returns 1 if the call must be issued, and records the new value.
+static int update(Slot* slot, GLuint value) {
+    if (slot->known && slot->value == value) {
+        current.elided++;
+        return 0;
+    }
+    slot->value = value;
+    slot->known = 1;
+    current.issued++;
+    return 1;
+}
+
+static int buffer_slot(GLenum target) {
+    for (int i = 0; i < BUFFER_TARGETS; i++) {
+        if (bufferTargets[i] == target) return i;
+    }
+    return -1;
+}
+
+void state_invalidate(void) {
+    memset(&program, 0, sizeof(program));
+    memset(&vertexArray, 0, sizeof(vertexArray));
+    memset(buffers, 0, sizeof(buffers));
+    memset(caps, 0, sizeof(caps));
+    memset(uniformRanges, 0, sizeof(uniformRanges));
+}
+
+void state_use_program(GLuint p) {
+    if (update(&program, p)) glUseProgram(p);
+}
+
+void state_bind_vertex_array(GLuint vao) {
+    if (update(&vertexArray, vao)) glBindVertexArray(vao);
+}
+
+void state_bind_buffer(GLenum target, GLuint buffer) {
+    int i = buffer_slot(target);
+    if (i < 0) {
+        current.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (update(&buffers[i], buffer)) glBindBuffer(target, buffer);
+}
+
+void state_bind_buffer_range(GLenum target, GLuint index, GLuint buffer,
+                             GLintptr offset, GLsizeiptr size) {
+    if (target == GL_UNIFORM_BUFFER && index < UNIFORM_BINDINGS) {
+        RangeSlot* r = &uniformRanges[index];
+        if (r->known && r->buffer == buffer && r->offset == offset && r->size == size) {
+            current.elided++;
+            return;
+        }
+        *r = (RangeSlot){ buffer, offset, size, 1 };
+    }
+    current.issued++;
+    glBindBufferRange(target, index, buffer, offset, size);
+
+    // Also binds the generic target, like glBindBuffer would.
+    int i = buffer_slot(target);
+    if (i >= 0) buffers[i] = (Slot){ buffer, 1 };
+}
+
+void state_set_capability(GLenum cap, int enabled) {
+    for (int i = 0; i < CAPABILITIES; i++) {
+        if (capabilities[i] != cap) continue;
+        if (!update(&caps[i], enabled ? 1 : 0)) return;
+        if (enabled) glEnable(cap); else glDisable(cap);
+        return;
+    }
+    current.issued++;
+    if (enabled) glEnable(cap); else glDisable(cap);
+}
+
+void state_forget_program(GLuint p) {
+    if (program.known && program.value == p) program.known = 0;
+}
+
+void state_forget_vertex_array(GLuint vao) {
+    if (vertexArray.known && vertexArray.value == vao) vertexArray.known = 0;
+}
+
+void state_forget_buffer(GLuint buffer) {
+    for (int i = 0; i < BUFFER_TARGETS; i++) {
+        if (buffers[i].known && buffers[i].value == buffer) buffers[i].known = 0;
+    }
+    for (int i = 0; i < UNIFORM_BINDINGS; i++) {
+        if (uniformRanges[i].known && uniformRanges[i].buffer == buffer) {
+            uniformRanges[i].known = 0;
+        }
+    }
+}
+
+void state_end_frame(void) {
+    last = current;
+    memset(&current, 0, sizeof(current));
+}
+
+StateStats state_stats(void) {
+    return last;
+}
+
+void state_report(FILE* out) {
+    fprintf(out, "state: %u GL calls issued, %u elided last frame\n", last.issued, last.elided);
+}
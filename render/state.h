@@ -0,0 +1,44 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include <glad/glad.h>
+#include <stdio.h>
+
+// ------------------------------------------------------------------
+// GL state cache (render/state.c):
+// shadows the bound program, VAO, buffer bindings, a few capability
+// bits and uniform block ranges, and drops calls that would not
+// change anything. Everything under shape/ and shader/ goes through it, so
+// code that calls GL directly must call state_invalidate() afterwards.
+// ------------------------------------------------------------------
+
+typedef struct {
+    unsigned issued;   // GL calls passed to the driver
+    unsigned elided;   // calls skipped because the state already matched
+} StateStats;
+
+// Forget every shadowed value; the next call of each kind goes to GL.
+void state_invalidate(void);
+
+void state_use_program(GLuint program);
+void state_bind_vertex_array(GLuint vao);
+// GL_ELEMENT_ARRAY_BUFFER is VAO state and is always passed through.
+void state_bind_buffer(GLenum target, GLuint buffer);
+void state_bind_buffer_range(GLenum target, GLuint index, GLuint buffer,
+                             GLintptr offset, GLsizeiptr size);
+// GL_BLEND, GL_DEPTH_TEST and GL_CULL_FACE are cached, others pass through.
+void state_set_capability(GLenum cap, int enabled);
+
+// Call after glDelete* so a recycled name is not mistaken for bound state.
+void state_forget_program(GLuint program);
+void state_forget_vertex_array(GLuint vao);
+void state_forget_buffer(GLuint buffer);
+
+// Ends the frame: the counters restart and state_stats() returns the
+// totals of the frame that just finished.
+void       state_end_frame(void);
+StateStats state_stats(void);
+// One line with state_stats().
+void       state_report(FILE* out);
+
+#endif // STATE_H
@@ -0,0 +1,309 @@
+// render/stream.c
+#include <glad/glad.h>
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+#include "state.h"
+
+// -----------------------------------------------------------------------------
+// Ring buffer for per-frame data, with three upload strategies:
+//
+//   PERSISTENT     – storage from glBufferStorage, mapped once (persistent +
+//                    coherent); writes go straight into GPU-visible memory.
+//   UNSYNCHRONIZED – glMapBufferRange(UNSYNCHRONIZED | INVALIDATE_RANGE) on
+//                    each write; the driver does no implicit sync.
+//   ORPHAN         – glBufferSubData from a CPU staging copy; when the ring
+//                    wraps, the storage is orphaned with glBufferData(NULL).
+//
+// The first two rely on our own fences: stream_fence() drops a fence at the
+// current head, and before a write reuses memory from an earlier lap we wait
+// (glClientWaitSync) only for the fences covering that memory. ORPHAN needs
+// no fences: glBufferSubData is implicitly synchronized and orphaning gives
+// the driver a fresh allocation instead of a stall.
+// -----------------------------------------------------------------------------
+
+#define CAPACITY_ALIGN 256
+#define WAIT_TIMEOUT_NS 1000000000ull   // per glClientWaitSync attempt
+
+static StreamStrategy autoStrategy = STREAM_AUTO;
+
+static const char* strategyNames[STREAM_STRATEGY_COUNT] = {
+    "auto", "persistent", "unsynchronized", "orphan",
+};
+
+const char* stream_strategy_name(StreamStrategy strategy) {
+    if (strategy < 0 || strategy >= STREAM_STRATEGY_COUNT) return "unknown";
+    return strategyNames[strategy];
+}
+
+static int supported(StreamStrategy strategy) {
+    // glBufferStorage and persistent mapping are core in 4.4
+    if (strategy == STREAM_PERSISTENT) return GLAD_GL_VERSION_4_4;
+    return 1;
+}
+
+static StreamStrategy resolve(StreamStrategy strategy) {
+    if (strategy == STREAM_AUTO) {
+        strategy = autoStrategy != STREAM_AUTO ? autoStrategy
+                 : GLAD_GL_VERSION_4_4 ? STREAM_PERSISTENT : STREAM_UNSYNCHRONIZED;
+    }
+    return supported(strategy) ? strategy : STREAM_UNSYNCHRONIZED;
+}
+
+// ---- storage ----------------------------------------------------------------
+
+static int create_storage(StreamBuffer* sb) {
+    glGenBuffers(1, &sb->buffer);
+    state_bind_buffer(sb->target, sb->buffer);
+
+    if (sb->strategy == STREAM_PERSISTENT) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(sb->target, sb->capacity, NULL, flags);
+        sb->persistent = glMapBufferRange(sb->target, 0, sb->capacity, flags);
+        if (!sb->persistent) {
+            fprintf(stderr, "stream: persistent mapping failed\n");
+            return -1;
+        }
+    } else {
+        glBufferData(sb->target, sb->capacity, NULL, GL_STREAM_DRAW);
+    }
+    return 0;
+}
+
+static void release_storage(StreamBuffer* sb) {
+    for (int i = 0; i < sb->fenceCount; i++) {
+        glDeleteSync(sb->fences[(sb->fenceFirst + i) % STREAM_MAX_FENCES].sync);
+    }
+    sb->fenceFirst = sb->fenceCount = 0;
+
+    if (sb->buffer) {
+        if (sb->persistent) {
+            state_bind_buffer(sb->target, sb->buffer);
+            glUnmapBuffer(sb->target);
+            sb->persistent = NULL;
+        }
+        // Draws already submitted keep the storage alive until they finish
+        glDeleteBuffers(1, &sb->buffer);
+        state_forget_buffer(sb->buffer);
+        sb->buffer = 0;
+    }
+    sb->head = sb->fencedUpTo = sb->retiredUpTo = 0;
+}
+
+int stream_init(StreamBuffer* sb, GLenum target, GLsizeiptr capacity, StreamStrategy strategy) {
+    memset(sb, 0, sizeof(*sb));
+    sb->target   = target;
+    sb->capacity = (capacity + CAPACITY_ALIGN - 1) / CAPACITY_ALIGN * CAPACITY_ALIGN;
+    sb->strategy = resolve(strategy);
+    if (create_storage(sb) != 0) {
+        stream_destroy(sb);
+        return -1;
+    }
+    return 0;
+}
+
+void stream_destroy(StreamBuffer* sb) {
+    release_storage(sb);
+    free(sb->staging);
+    sb->staging = NULL;
+    sb->stagingSize = 0;
+}
+
+int stream_reserve(StreamBuffer* sb, GLsizeiptr bytesPerFrame) {
+    GLsizeiptr need = bytesPerFrame * 3;
+    if (need <= sb->capacity) return 0;
+
+    release_storage(sb);
+    sb->capacity = (need + CAPACITY_ALIGN - 1) / CAPACITY_ALIGN * CAPACITY_ALIGN;
+    return create_storage(sb);
+}
+
+// ---- fences -----------------------------------------------------------------
+
+// Blocks until every byte below virtual offset `needed` is no longer read.
+static void retire_until(StreamBuffer* sb, GLuint64 needed) {
+    while (sb->fenceCount > 0 && sb->retiredUpTo < needed) {
+        StreamFence* f = &sb->fences[sb->fenceFirst];
+        GLenum result;
+        do {
+            result = glClientWaitSync(f->sync, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        if (result == GL_CONDITION_SATISFIED) sb->stalls++;
+
+        glDeleteSync(f->sync);
+        sb->retiredUpTo = f->end;
+        sb->fenceFirst = (sb->fenceFirst + 1) % STREAM_MAX_FENCES;
+        sb->fenceCount--;
+    }
+}
+
+void stream_fence(StreamBuffer* sb) {
+    if (sb->head == sb->fencedUpTo) return;
+    sb->fencedUpTo = sb->head;
+    if (sb->strategy == STREAM_ORPHAN) {
+        sb->retiredUpTo = sb->head;
+        return;
+    }
+
+    if (sb->fenceCount == STREAM_MAX_FENCES) {
+        // Out of slots: retire the oldest fence to make room.
+        retire_until(sb, sb->fences[sb->fenceFirst].end);
+    }
+    int slot = (sb->fenceFirst + sb->fenceCount) % STREAM_MAX_FENCES;
+    sb->fences[slot].sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    sb->fences[slot].end  = sb->head;
+    sb->fenceCount++;
+}
+
+// ---- writes -----------------------------------------------------------------
+
+void* stream_map(StreamBuffer* sb, GLsizeiptr size, GLsizeiptr align, GLintptr* offset) {
+    if (size <= 0 || size > sb->capacity) return NULL;
+    if (align < 1) align = 1;
+
+    GLuint64 cap = (GLuint64)sb->capacity;
+    GLuint64 pos = (sb->head + align - 1) / align * align;
+    GLuint64 physical = pos % cap;
+    if (physical + size > cap) {
+        // Never split a write across the end of the ring
+        pos += cap - physical;
+        physical = 0;
+    }
+    if (pos + size - sb->fencedUpTo > cap) {
+        // Would overwrite data written since the last stream_fence()
+        return NULL;
+    }
+
+    int newLap = pos / cap != sb->head / cap || (sb->head > 0 && physical == 0);
+    state_bind_buffer(sb->target, sb->buffer);
+
+    // PERSISTENT and UNSYNCHRONIZED wait for the GPU to release the bytes
+    // of the previous lap they reuse; in the first lap there are none.
+    char* ptr = NULL;
+    switch (sb->strategy) {
+        case STREAM_PERSISTENT:
+            if (pos + size > cap) retire_until(sb, pos + size - cap);
+            ptr = sb->persistent + physical;
+            break;
+
+        case STREAM_UNSYNCHRONIZED:
+            if (pos + size > cap) retire_until(sb, pos + size - cap);
+            ptr = glMapBufferRange(sb->target, physical, size,
+                                   GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                   GL_MAP_INVALIDATE_RANGE_BIT);
+            break;
+
+        default:   // STREAM_ORPHAN
+            if (newLap && sb->fencedUpTo == sb->head) {
+                glBufferData(sb->target, sb->capacity, NULL, GL_STREAM_DRAW);
+            }
+            if (size > sb->stagingSize) {
+                char* grown = realloc(sb->staging, size);
+                if (!grown) return NULL;
+                sb->staging = grown;
+                sb->stagingSize = size;
+            }
+            ptr = sb->staging;
+            break;
+    }
+    if (!ptr) return NULL;
+
+    sb->head      = pos + size;
+    sb->mapOffset = (GLintptr)physical;
+    sb->mapSize   = size;
+    *offset = (GLintptr)physical;
+    return ptr;
+}
+
+void stream_unmap(StreamBuffer* sb) {
+    if (sb->mapSize == 0) return;
+    state_bind_buffer(sb->target, sb->buffer);
+    if (sb->strategy == STREAM_UNSYNCHRONIZED) {
+        glUnmapBuffer(sb->target);
+    } else if (sb->strategy == STREAM_ORPHAN) {
+        glBufferSubData(sb->target, sb->mapOffset, sb->mapSize, sb->staging);
+    }
+    sb->mapSize = 0;
+}
+
+GLintptr stream_write(StreamBuffer* sb, const void* data, GLsizeiptr size, GLsizeiptr align) {
+    GLintptr offset;
+    void* dst = stream_map(sb, size, align, &offset);
+    if (!dst) return -1;
+    memcpy(dst, data, size);
+    stream_unmap(sb);
+    return offset;
+}
+
+// ---- strategy microbenchmark -------------------------------------------------
+
+#define BENCH_FRAMES 24
+#define BENCH_WARMUP 4
+#define BENCH_CHUNKS 4
+
+static double bench_strategy(StreamStrategy strategy, GLsizeiptr bytesPerFrame,
+                             const char* data, GLuint sink) {
+    StreamBuffer sb;
+    if (stream_init(&sb, GL_ARRAY_BUFFER, bytesPerFrame * 3, strategy) != 0) return -1.0;
+
+    GLsizeiptr chunk = bytesPerFrame / BENCH_CHUNKS;
+    Uint64 start = 0;
+    for (int frame = 0; frame < BENCH_WARMUP + BENCH_FRAMES; frame++) {
+        if (frame == BENCH_WARMUP) {
+            glFinish();
+            start = SDL_GetPerformanceCounter();
+        }
+        for (int c = 0; c < BENCH_CHUNKS; c++) {
+            GLintptr offset = stream_write(&sb, data + c * chunk, chunk, CAPACITY_ALIGN);
+            if (offset < 0) break;
+            // Make the GPU read what was just written, like a draw would
+            state_bind_buffer(GL_COPY_WRITE_BUFFER, sink);
+            glCopyBufferSubData(GL_ARRAY_BUFFER, GL_COPY_WRITE_BUFFER,
+                                offset, c * chunk, chunk);
+        }
+        stream_fence(&sb);
+        glFlush();
+    }
+    glFinish();
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+    stream_destroy(&sb);
+    return (double)elapsed * 1000.0 / (double)SDL_GetPerformanceFrequency() / BENCH_FRAMES;
+}
+
+StreamStrategy stream_pick_strategy(GLsizeiptr bytesPerFrame) {
+    bytesPerFrame = (bytesPerFrame + BENCH_CHUNKS * CAPACITY_ALIGN - 1)
+                  / (BENCH_CHUNKS * CAPACITY_ALIGN) * (BENCH_CHUNKS * CAPACITY_ALIGN);
+    char* data = malloc(bytesPerFrame);
+    if (!data) return resolve(STREAM_AUTO);
+    memset(data, 0x5a, bytesPerFrame);
+
+    GLuint sink;
+    glGenBuffers(1, &sink);
+    state_bind_buffer(GL_COPY_WRITE_BUFFER, sink);
+    glBufferData(GL_COPY_WRITE_BUFFER, bytesPerFrame, NULL, GL_STREAM_COPY);
+
+    StreamStrategy best = STREAM_AUTO;
+    double bestMs = 0.0;
+    printf("stream: %ld KiB/frame |", (long)(bytesPerFrame / 1024));
+    for (int s = STREAM_PERSISTENT; s < STREAM_STRATEGY_COUNT; s++) {
+        if (!supported(s)) continue;
+        double ms = bench_strategy(s, bytesPerFrame, data, sink);
+        if (ms < 0.0) continue;
+        printf(" %s %.3f ms", strategyNames[s], ms);
+        if (best == STREAM_AUTO || ms < bestMs) {
+            best = s;
+            bestMs = ms;
+        }
+    }
+
+    glDeleteBuffers(1, &sink);
+    state_forget_buffer(sink);
+    free(data);
+
+    autoStrategy = best != STREAM_AUTO ? best : resolve(STREAM_AUTO);
+    printf(" | using %s\n", strategyNames[autoStrategy]);
+    return autoStrategy;
+}
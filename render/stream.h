@@ -0,0 +1,78 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <glad/glad.h>
+
+// ------------------------------------------------------------------
+// Streaming buffer (render/stream.c):
+// a ring of GPU memory for data rewritten every frame (instances,
+// indirect commands, uniform blocks). Regions the GPU may still be
+// reading are protected by fences, so writers never stall on a
+// buffer-wide sync unless the ring is genuinely full.
+// ------------------------------------------------------------------
+
+typedef enum {
+    STREAM_AUTO = 0,        // whatever stream_pick_strategy() chose
+    STREAM_PERSISTENT,      // glBufferStorage + persistent coherent map (GL 4.4)
+    STREAM_UNSYNCHRONIZED,  // glMapBufferRange(UNSYNCHRONIZED) guarded by fences
+    STREAM_ORPHAN,          // glBufferSubData, orphaned with glBufferData on wrap
+    STREAM_STRATEGY_COUNT
+} StreamStrategy;
+
+#define STREAM_MAX_FENCES 8
+
+typedef struct {
+    GLsync     sync;
+    GLuint64   end;         // virtual offset the fence protects up to
+} StreamFence;
+
+typedef struct {
+    GLuint         buffer;
+    GLenum         target;
+    GLsizeiptr     capacity;
+    StreamStrategy strategy;
+    char*          persistent;   // mapping for STREAM_PERSISTENT
+
+    // Offsets below are "virtual": they only ever grow, and the physical
+    // offset is virtual % capacity. That makes overlap tests trivial.
+    GLuint64    head;            // next free byte
+    GLuint64    fencedUpTo;      // everything below is covered by a fence
+    GLuint64    retiredUpTo;     // everything below is known to be consumed
+    StreamFence fences[STREAM_MAX_FENCES];
+    int         fenceFirst, fenceCount;
+    unsigned    stalls;          // waits that actually blocked
+
+    // Pending write from stream_map(), finished by stream_unmap().
+    GLintptr    mapOffset;
+    GLsizeiptr  mapSize;
+    char*       staging;         // CPU copy for STREAM_ORPHAN
+    GLsizeiptr  stagingSize;
+} StreamBuffer;
+
+int  stream_init(StreamBuffer* sb, GLenum target, GLsizeiptr capacity, StreamStrategy strategy);
+void stream_destroy(StreamBuffer* sb);
+
+// Returns a CPU pointer for `size` bytes at an `align`-aligned offset
+// (stored in *offset), waiting only if that region is still in flight.
+// NULL if `size` cannot fit next to the data already written since the
+// last stream_fence(). The buffer is left bound to sb->target.
+void* stream_map(StreamBuffer* sb, GLsizeiptr size, GLsizeiptr align, GLintptr* offset);
+void  stream_unmap(StreamBuffer* sb);
+
+// map + memcpy + unmap. Returns the offset, or -1 on failure.
+GLintptr stream_write(StreamBuffer* sb, const void* data, GLsizeiptr size, GLsizeiptr align);
+
+// Call once the draws reading everything written so far are submitted.
+void stream_fence(StreamBuffer* sb);
+
+// Grows the ring (dropping its contents) so that `bytesPerFrame` can be
+// written every frame with three frames in flight.
+int  stream_reserve(StreamBuffer* sb, GLsizeiptr bytesPerFrame);
+
+// Times every strategy the context supports by streaming `bytesPerFrame`
+// per frame through a scratch ring with the GPU copying it out, and makes
+// the fastest one the STREAM_AUTO default.
+StreamStrategy stream_pick_strategy(GLsizeiptr bytesPerFrame);
+const char*    stream_strategy_name(StreamStrategy strategy);
+
+#endif // STREAM_H
@@ -0,0 +1,169 @@
+// render/transform.c
+#include <cglm/cglm.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transform.h"
+#include "../core/cpu.h"
+
+// -----------------------------------------------------------------------------
+// With q = (x, y, z, w) and scale (sx, sy, sz), T * R * S has the columns
+//
+//     (1 - 2(yy + zz), 2(xy + wz),      2(xz - wy)     ) * sx
+//     (2(xy - wz),     1 - 2(xx + zz),  2(yz + wx)     ) * sy
+//     (2(xz + wy),     2(yz - wx),      1 - 2(xx + yy) ) * sz
+//     (px,             py,              pz             ), 1
+//
+// and column c of parent * M is the sum over k of parent column k times
+// M[c][k]. The kernels compute these 16 values for W objects at once, one
+// vector per matrix element with one object per lane, then transpose the 16
+// vectors so each object's matrix is stored contiguously. They are built for
+// every level in core/cpu.h (W = 1, 4, 8 and 16) and the builds call the one
+// cpu_level() picked.
+// -----------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define ARRAY_ALIGN 32
+
+// ---- storage ----------------------------------------------------------------
+
+static void arrays(TransformSet* set, float** out[10]) {
+    out[0] = &set->px; out[1] = &set->py; out[2] = &set->pz;
+    out[3] = &set->qx; out[4] = &set->qy; out[5] = &set->qz; out[6] = &set->qw;
+    out[7] = &set->sx; out[8] = &set->sy; out[9] = &set->sz;
+}
+
+void transform_set_init(TransformSet* set) {
+    memset(set, 0, sizeof(*set));
+}
+
+void transform_set_free(TransformSet* set) {
+    float** a[10];
+    arrays(set, a);
+    for (int i = 0; i < 10; i++) {
+        free(*a[i]);
+        *a[i] = NULL;
+    }
+    set->count = set->capacity = 0;
+}
+
+static int grow(TransformSet* set) {
+    if (set->count < set->capacity) return 0;
+    int cap = set->capacity ? set->capacity * 2 : 64;
+    size_t bytes = sizeof(float) * cap;
+
+    float** a[10];
+    arrays(set, a);
+    float* grown[10] = {0};
+    for (int i = 0; i < 10; i++) {
+        grown[i] = aligned_alloc(ARRAY_ALIGN, bytes);
+        if (!grown[i]) {
+            for (int j = 0; j < i; j++) free(grown[j]);
+            return -1;
+        }
+    }
+    for (int i = 0; i < 10; i++) {
+        if (*a[i]) memcpy(grown[i], *a[i], sizeof(float) * set->count);
+        free(*a[i]);
+        *a[i] = grown[i];
+    }
+    set->capacity = cap;
+    return 0;
+}
+
+int transform_set_add(TransformSet* set, const vec3 position, const versor rotation,
+                      const vec3 scale) {
+    if (grow(set) != 0) return -1;
+    int i = set->count++;
+    set->px[i] = position[0]; set->py[i] = position[1]; set->pz[i] = position[2];
+    set->qx[i] = rotation[0]; set->qy[i] = rotation[1];
+    set->qz[i] = rotation[2]; set->qw[i] = rotation[3];
+    set->sx[i] = scale[0];    set->sy[i] = scale[1];    set->sz[i] = scale[2];
+    return i;
+}
+
+// ---- build ------------------------------------------------------------------
+
+// One object, and the tail of a run that does not fill a group
+static void build_one(const TransformSet* s, int o, mat4 parent, mat4 out) {
+    float x = s->qx[o], y = s->qy[o], z = s->qz[o], w = s->qw[o];
+    float m[4][3] = {
+        { (1.0f - 2.0f * (y * y + z * z)) * s->sx[o],
+          2.0f * (x * y + w * z) * s->sx[o],
+          2.0f * (x * z - w * y) * s->sx[o] },
+        { 2.0f * (x * y - w * z) * s->sy[o],
+          (1.0f - 2.0f * (x * x + z * z)) * s->sy[o],
+          2.0f * (y * z + w * x) * s->sy[o] },
+        { 2.0f * (x * z + w * y) * s->sz[o],
+          2.0f * (y * z - w * x) * s->sz[o],
+          (1.0f - 2.0f * (x * x + y * y)) * s->sz[o] },
+        { s->px[o], s->py[o], s->pz[o] },
+    };
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            if (!parent) {
+                out[c][r] = r < 3 ? m[c][r] : (c == 3 ? 1.0f : 0.0f);
+                continue;
+            }
+            out[c][r] = parent[0][r] * m[c][0] + parent[1][r] * m[c][1]
+                      + parent[2][r] * m[c][2] + (c == 3 ? parent[3][r] : 0.0f);
+        }
+    }
+}
+
+#define W 1
+#define KERNEL(name) name##_scalar
+#include "transform_kernel.inc"
+
+#if defined(__SSE2__)
+#define W 4
+#define KERNEL(name) name##_sse
+#include "transform_kernel.inc"
+#endif
+
+#if CPU_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define W 8
+#define KERNEL(name) name##_avx2
+#include "transform_kernel.inc"
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define W 16
+#define KERNEL(name) name##_avx512
+#include "transform_kernel.inc"
+#pragma GCC pop_options
+#endif
+
+typedef void (*BuildFn)(const TransformSet* set, const int* idx, int first, int count,
+                        mat4 parent, mat4* out);
+
+static BuildFn kernel(void) {
+    switch (cpu_level()) {
+#if CPU_TARGET_PRAGMAS
+    case CPU_AVX512: return build_avx512;
+    case CPU_AVX2:   return build_avx2;
+#endif
+#if defined(__SSE2__)
+    case CPU_SSE:    return build_sse;
+#endif
+    default:         return build_scalar;
+    }
+}
+
+void transform_build(const TransformSet* set, int first, int count, mat4 parent, mat4* out) {
+    kernel()(set, NULL, first, count, parent, out);
+}
+
+void transform_build_indexed(const TransformSet* set, const int* idx, int count,
+                             mat4 parent, mat4* out) {
+    kernel()(set, idx, 0, count, parent, out);
+}
+
+const char* transform_kernel_name(void) {
+    return cpu_level_name(cpu_level());
+}
@@ -0,0 +1,48 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <cglm/cglm.h>
+
+// ------------------------------------------------------------------
+// Batch transforms (render/transform.c):
+// position, rotation (unit quaternion) and scale of many objects are
+// kept in structure-of-arrays form, and one call turns a run of them
+// into packed mat4s, parent * T * R * S, where the parent is the
+// view-projection (MVP matrices), a scene root, or nothing (model
+// matrices). W objects are built at a time with AVX-512 (16), AVX2
+// (8) or SSE (4), whichever core/cpu.h picked, then transposed into
+// the mat4s.
+// ------------------------------------------------------------------
+
+typedef struct {
+    float* px;   // position
+    float* py;
+    float* pz;
+    float* qx;   // rotation quaternion, w last as in cglm's versor
+    float* qy;
+    float* qz;
+    float* qw;
+    float* sx;   // scale
+    float* sy;
+    float* sz;
+    int    count;
+    int    capacity;
+} TransformSet;
+
+void transform_set_init(TransformSet* set);
+void transform_set_free(TransformSet* set);
+// Append an object; return its index, or -1 if out of memory.
+int  transform_set_add(TransformSet* set, const vec3 position, const versor rotation,
+                       const vec3 scale);
+
+// Objects [first, first + count) into out[0 .. count). `parent` may be
+// NULL.
+void transform_build(const TransformSet* set, int first, int count, mat4 parent, mat4* out);
+// Objects idx[0 .. count) into out[0 .. count).
+void transform_build_indexed(const TransformSet* set, const int* idx, int count,
+                             mat4 parent, mat4* out);
+
+// Name of the kernel in use ("avx512", "avx2", "sse" or "scalar").
+const char* transform_kernel_name(void);
+
+#endif // TRANSFORM_H
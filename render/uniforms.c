@@ -0,0 +1,63 @@
+// render/uniforms.c
+#include <glad/glad.h>
+#include <stdio.h>
+#include "uniforms.h"
+#include "state.h"
+#include "stream.h"
+
+// -----------------------------------------------------------------------------
+// All uniform blocks are sub-allocated from one StreamBuffer. Each push lands
+// at the next offset that satisfies GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and is
+// bound with glBindBufferRange, so blocks from earlier in the frame stay
+// valid for draws that have not executed yet. uniforms_end_frame() fences
+// the frame's blocks; the ring only waits if it laps a frame still in flight.
+// -----------------------------------------------------------------------------
+
+#define RING_BYTES (64 * 1024)
+
+static StreamBuffer  ring;
+static GLint         alignment = 256;
+
+int uniforms_init(void) {
+    uniforms_destroy();
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+
+    if (stream_init(&ring, GL_UNIFORM_BUFFER, RING_BYTES, STREAM_AUTO) != 0) return -1;
+    return glGetError() == GL_NO_ERROR ? 0 : -1;
+}
+
+void uniforms_destroy(void) {
+    stream_destroy(&ring);
+}
+
+void uniforms_end_frame(void) {
+    stream_fence(&ring);
+}
+
+GLintptr uniforms_push(GLuint binding, const void* data, GLsizeiptr size) {
+    GLintptr offset = stream_write(&ring, data, size, alignment);
+    if (offset < 0) {
+        fprintf(stderr, "uniforms_push: %ld byte block does not fit the ring\n", (long)size);
+        return -1;
+    }
+    state_bind_buffer_range(GL_UNIFORM_BUFFER, binding, ring.buffer, offset, size);
+    return offset;
+}
+
+void uniforms_begin_frame(const Camera* camera, float seconds) {
+    FrameUniforms f;
+    glm_mat4_copy((vec4*)camera->view, f.view);
+    glm_mat4_copy((vec4*)camera->proj, f.proj);
+    glm_mat4_copy((vec4*)camera->viewProj, f.viewProj);
+    f.time[0] = seconds;
+    f.time[1] = f.time[2] = f.time[3] = 0.0f;
+    f.viewport[0] = 0.0f;
+    f.viewport[1] = 0.0f;
+    f.viewport[2] = (float)camera->width;
+    f.viewport[3] = (float)camera->height;
+
+    // Without a GL context (software backend) there is nothing to upload
+    if (ring.buffer) uniforms_push(UNIFORMS_FRAME_BINDING, &f, sizeof(f));
+}
@@ -0,0 +1,53 @@
+#ifndef UNIFORMS_H
+#define UNIFORMS_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+#include "camera.h"
+
+// ------------------------------------------------------------------
+// Uniform buffers (render/uniforms.c):
+// one std140 "Frame" block with the camera, written once per frame,
+// and a ring buffer that hands out aligned ranges for any other
+// block (per-object or per-draw data) bound with glBindBufferRange.
+//
+// create_shader() binds the blocks by name to these fixed points.
+// ------------------------------------------------------------------
+#define UNIFORMS_FRAME_BINDING  0
+#define UNIFORMS_OBJECT_BINDING 1
+
+// Shared GLSL declaration; paste it into any shader that needs the camera.
+#define UNIFORMS_FRAME_GLSL \
+    "layout(std140) uniform Frame {\n" \
+    "    mat4 uView;\n" \
+    "    mat4 uProj;\n" \
+    "    mat4 uViewProj;\n" \
+    "    vec4 uTime;      // x = seconds since start\n" \
+    "    vec4 uViewport;  // x, y, width, height in pixels\n" \
+    "};\n"
+
+// CPU mirror of the Frame block; std140 needs no padding for this layout.
+typedef struct {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+    vec4 time;
+    vec4 viewport;
+} FrameUniforms;
+
+int  uniforms_init(void);
+void uniforms_destroy(void);
+
+// Fills and binds the Frame block from the camera (render/camera.h).
+// Call once per frame before drawing. On the CPU the matrices are read
+// from camera_current(), not from here.
+void uniforms_begin_frame(const Camera* camera, float seconds);
+
+// Fences everything pushed this frame. Call after the frame's draws.
+void uniforms_end_frame(void);
+
+// Copies `size` bytes into the ring and binds them to `binding`.
+// Returns the offset used, or -1 if the frame has filled the ring.
+GLintptr uniforms_push(GLuint binding, const void* data, GLsizeiptr size);
+
+#endif // UNIFORMS_H
@@ -0,0 +1,274 @@
+// shader/cache.c
+#include <glad/glad.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cache.h"
+
+// -----------------------------------------------------------------------------
+// File layout, all little-endian as written by this machine:
+//
+//     CacheHeader                       magic, version, entry count, driver hash,
+//                                       FNV-1a checksum of everything below it
+//     EntryHeader + binary, padded to 8 bytes, `count` times
+//
+// Entries loaded from the file point straight into the read-only mapping;
+// programs stored this run are owned copies until the file is rewritten at
+// shader_cache_close().
+// -----------------------------------------------------------------------------
+
+#define CACHE_MAGIC   "GLPROGC1"
+#define CACHE_VERSION 2   // 2: keys are normalized source hashes
+#define MAX_ENTRIES   64
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t driver;
+    uint64_t checksum;
+} CacheHeader;
+
+typedef struct {
+    uint64_t source;
+    uint32_t format;
+    uint32_t length;
+} EntryHeader;
+
+typedef struct {
+    uint64_t    source;
+    GLenum      format;
+    GLsizei     length;
+    const void* data;
+    int         owned;
+} Entry;
+
+static int    enabled = 0;
+static char*  cachePath = NULL;
+static void*  mapping = NULL;
+static size_t mappingSize = 0;
+static Entry  entries[MAX_ENTRIES];
+static int    entryCount = 0;
+static int    dirty = 0;
+static int    hits = 0, misses = 0;
+static uint64_t driverHash;
+
+// ---- hashing ----------------------------------------------------------------
+
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME  0x100000001b3ull
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const unsigned char* p = data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+// Strings are hashed with their terminator so "ab"+"c" != "a"+"bc".
+static uint64_t fnv1a_string(uint64_t h, const char* s) {
+    return fnv1a(h, s ? s : "", (s ? strlen(s) : 0) + 1);
+}
+
+static uint64_t driver_hash(void) {
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+    uint64_t h = FNV_OFFSET;
+    for (int i = 0; i < 4; i++) h = fnv1a_string(h, (const char*)glGetString(names[i]));
+    return h;
+}
+
+static size_t padded(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+// ---- file -------------------------------------------------------------------
+
+// Indexes a mapped file. Returns NULL if it is valid for this driver,
+// otherwise the reason it is ignored.
+static const char* read_entries(const unsigned char* bytes, size_t size) {
+    if (size < sizeof(CacheHeader)) return "truncated";
+    const CacheHeader* header = (const CacheHeader*)bytes;
+    if (memcmp(header->magic, CACHE_MAGIC, 8) != 0 || header->version != CACHE_VERSION) {
+        return "unknown format";
+    }
+    if (header->driver != driverHash) return "built by another driver";
+    if (fnv1a(FNV_OFFSET, bytes + sizeof(CacheHeader), size - sizeof(CacheHeader))
+        != header->checksum) {
+        return "checksum mismatch";
+    }
+
+    size_t at = sizeof(CacheHeader);
+    for (uint32_t i = 0; i < header->count && entryCount < MAX_ENTRIES; i++) {
+        if (size - at < sizeof(EntryHeader)) return "truncated";
+        const EntryHeader* e = (const EntryHeader*)(bytes + at);
+        at += sizeof(EntryHeader);
+        // Every entry is written padded, the last one too
+        if (padded(e->length) > size - at) return "truncated";
+        entries[entryCount++] = (Entry){
+            .source = e->source,
+            .format = e->format,
+            .length = (GLsizei)e->length,
+            .data   = bytes + at,
+        };
+        at += padded(e->length);
+    }
+    return NULL;
+}
+
+static void map_file(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;   // first run
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            mapping = p;
+            mappingSize = (size_t)st.st_size;
+        }
+    }
+    close(fd);   // the mapping stays valid
+    if (!mapping) return;
+
+    const char* problem = read_entries(mapping, mappingSize);
+    if (problem) {
+        printf("shader cache: ignoring %s (%s)\n", path, problem);
+        entryCount = 0;
+        dirty = 1;   // replace it with programs from this driver
+    }
+}
+
+static int write_file(const char* path) {
+    size_t tmpLength = strlen(path) + 5;
+    char* tmp = malloc(tmpLength);
+    if (!tmp) return -1;
+    snprintf(tmp, tmpLength, "%s.tmp", path);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        free(tmp);
+        return -1;
+    }
+
+    CacheHeader header = { .version = CACHE_VERSION, .count = entryCount, .driver = driverHash };
+    memcpy(header.magic, CACHE_MAGIC, 8);
+    fwrite(&header, sizeof(header), 1, f);   // checksum filled in below
+
+    static const unsigned char zeros[8] = {0};
+    uint64_t sum = FNV_OFFSET;
+    for (int i = 0; i < entryCount; i++) {
+        EntryHeader e = { entries[i].source, entries[i].format, (uint32_t)entries[i].length };
+        size_t pad = padded(e.length) - e.length;
+        fwrite(&e, sizeof(e), 1, f);
+        fwrite(entries[i].data, 1, e.length, f);
+        fwrite(zeros, 1, pad, f);
+        sum = fnv1a(sum, &e, sizeof(e));
+        sum = fnv1a(sum, entries[i].data, e.length);
+        sum = fnv1a(sum, zeros, pad);
+    }
+    header.checksum = sum;
+    fseek(f, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, f);
+
+    // Written aside and renamed, so a crash never leaves half a cache
+    int failed = ferror(f) != 0;
+    failed |= fclose(f) != 0;
+    if (!failed) failed = rename(tmp, path) != 0;
+    if (failed) remove(tmp);
+    free(tmp);
+    return failed ? -1 : 0;
+}
+
+// ---- API --------------------------------------------------------------------
+
+int shader_cache_open(const char* path) {
+    shader_cache_close();
+    GLint formats = 0;
+    if (GLAD_GL_VERSION_4_1) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0) {
+        printf("shader cache: driver has no program binary format, compiling from source\n");
+        return -1;
+    }
+
+    cachePath = malloc(strlen(path) + 1);
+    if (!cachePath) return -1;
+    strcpy(cachePath, path);
+    driverHash = driver_hash();
+    hits = misses = 0;
+    dirty = 0;
+    map_file(path);
+    enabled = 1;
+    return 0;
+}
+
+void shader_cache_close(void) {
+    if (!enabled) return;
+    if (dirty) {
+        if (write_file(cachePath) != 0) {
+            fprintf(stderr, "shader cache: cannot write %s\n", cachePath);
+        }
+    }
+    printf("shader cache: %d hits, %d misses, %d programs%s\n",
+           hits, misses, entryCount, dirty ? " written" : "");
+
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].owned) free((void*)entries[i].data);
+    }
+    entryCount = 0;
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = NULL;
+    free(cachePath);
+    cachePath = NULL;
+    enabled = 0;
+}
+
+GLuint shader_cache_load(uint64_t key) {
+    if (!enabled) return 0;
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].source != key) continue;
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, entries[i].format, entries[i].data, entries[i].length);
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked) {
+            hits++;
+            return program;
+        }
+        // e.g. a driver update that kept its version string
+        glDeleteProgram(program);
+        break;
+    }
+    misses++;
+    return 0;
+}
+
+void shader_cache_prepare(GLuint program) {
+    if (enabled) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void shader_cache_store(GLuint program, uint64_t key) {
+    if (!enabled) return;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    void* data = length > 0 ? malloc(length) : NULL;
+    if (!data) return;
+    GLenum format;
+    glGetProgramBinary(program, length, &length, &format, data);
+
+    int slot = 0;
+    while (slot < entryCount && entries[slot].source != key) slot++;
+    if (slot == MAX_ENTRIES) {
+        free(data);
+        return;
+    }
+    if (slot < entryCount && entries[slot].owned) free((void*)entries[slot].data);
+    if (slot == entryCount) entryCount++;
+    entries[slot] = (Entry){ key, format, length, data, 1 };
+    dirty = 1;
+}
@@ -0,0 +1,31 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <stdint.h>
+#include <glad/glad.h>
+
+// ------------------------------------------------------------------
+// Program binary cache (shader/cache.c):
+// linked programs are saved with glGetProgramBinary into one file,
+// keyed by shader_source_hash() of their GLSL, and the whole file is
+// tied to the driver by a hash of GL_VENDOR, GL_RENDERER, GL_VERSION and
+// GL_SHADING_LANGUAGE_VERSION (the version string carries the driver
+// build). The file is memory-mapped and its checksum checked when
+// opened; a different driver, a bad checksum or a binary the driver
+// refuses all fall back to compiling from source.
+// ------------------------------------------------------------------
+
+// After the GL context exists. Returns 0 if the cache is usable (even
+// if empty), -1 if the driver has no program binary format.
+int  shader_cache_open(const char* path);
+// Writes the file back if programs were added, then unmaps it.
+void shader_cache_close(void);
+
+// A linked program for this source hash, or 0 on a miss.
+GLuint shader_cache_load(uint64_t key);
+// Call between glCreateProgram() and glLinkProgram() of a program that
+// will be stored: some drivers only keep a binary when asked to.
+void   shader_cache_prepare(GLuint program);
+void   shader_cache_store(GLuint program, uint64_t key);
+
+#endif // SHADER_CACHE_H
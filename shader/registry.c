@@ -0,0 +1,197 @@
+// shader/registry.c
+#include <glad/glad.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "registry.h"
+#include "shader.h"
+#include "../render/state.h"
+
+#define NAME_LENGTH 32
+
+typedef struct {
+    char  name[NAME_LENGTH];
+    GLint location;
+} Location;
+
+struct ShaderProgram {
+    int      refs;      // 0 marks a free slot
+    GLuint   program;   // 0 while building, or if the build failed
+    int      pending;   // `build` has not been finished yet
+    ShaderBuild build;
+    uint64_t hash;
+    Location uniforms[SHADER_MAX_LOCATIONS];
+    Location attributes[SHADER_MAX_LOCATIONS];
+    int      uniformCount, attributeCount;
+};
+
+static ShaderProgram programs[SHADER_REGISTRY_MAX];
+
+// ---- hashing ----------------------------------------------------------------
+
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME  0x100000001b3ull
+
+static uint64_t fnv1a_byte(uint64_t h, unsigned char c) {
+    return (h ^ c) * FNV_PRIME;
+}
+
+// Character classes: whitespace between two characters of the same class
+// may separate tokens ("a b", "i++ + j"), between different ones it cannot.
+#define CLASS_NONE  0
+#define CLASS_WORD  1
+#define CLASS_PUNCT 2
+
+static int char_class(int c) {
+    return isalnum(c) || c == '_' || c == '.' ? CLASS_WORD : CLASS_PUNCT;
+}
+
+// Hashes the source as if it had been rewritten with comments removed,
+// preprocessor lines kept one per line and everything else reduced to
+// its tokens, separated by a space only where two words or two operators
+// would merge. So "vec4(aPos,1.0)" and "vec4( aPos, 1.0 ) // w = 1" hash
+// the same, while "i++ + j" and "i + ++j" do not.
+static uint64_t hash_normalized(uint64_t h, const char* s) {
+    int pendingSpace = 0, last = CLASS_NONE, directive = 0, lineStart = 1;
+    while (*s) {
+        if (s[0] == '/' && s[1] == '/') {
+            while (*s && *s != '\n') s++;
+            continue;
+        }
+        if (s[0] == '/' && s[1] == '*') {
+            s += 2;
+            while (*s && !(s[0] == '*' && s[1] == '/')) s++;
+            if (*s) s += 2;
+            pendingSpace = 1;
+            continue;
+        }
+        if (*s == '\n') {
+            // A directive ends at its newline, which is then significant
+            if (directive) {
+                h = fnv1a_byte(h, '\n');
+                last = CLASS_NONE;
+            }
+            directive = 0;
+            lineStart = 1;
+            pendingSpace = 1;
+            s++;
+            continue;
+        }
+        if (isspace((unsigned char)*s)) {
+            pendingSpace = 1;
+            s++;
+            continue;
+        }
+        if (lineStart && *s == '#') directive = 1;
+        lineStart = 0;
+
+        int class = char_class((unsigned char)*s);
+        if (pendingSpace && class == last) h = fnv1a_byte(h, ' ');
+        h = fnv1a_byte(h, (unsigned char)*s);
+        pendingSpace = 0;
+        last = class;
+        s++;
+    }
+    return fnv1a_byte(h, 0);   // separates the two stages
+}
+
+uint64_t shader_source_hash(const char* vertex, const char* fragment) {
+    return hash_normalized(hash_normalized(FNV_OFFSET, vertex), fragment);
+}
+
+// ---- registry ---------------------------------------------------------------
+
+ShaderProgram* shader_acquire(const char* vertex, const char* fragment) {
+    uint64_t hash = shader_source_hash(vertex, fragment);
+    ShaderProgram* slot = NULL;
+    for (int i = 0; i < SHADER_REGISTRY_MAX; i++) {
+        ShaderProgram* p = &programs[i];
+        if (p->refs > 0 && p->hash == hash) {
+            p->refs++;
+            return p;
+        }
+        if (p->refs == 0 && !slot) slot = p;
+    }
+    if (!slot) {
+        fprintf(stderr, "shader registry: more than %d programs\n", SHADER_REGISTRY_MAX);
+        return NULL;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    shader_submit(&slot->build, vertex, fragment, hash);
+    slot->pending = 1;
+    slot->hash = hash;
+    slot->refs = 1;
+    return slot;
+}
+
+static void finish(ShaderProgram* shader) {
+    shader->program = shader_finish(&shader->build);
+    shader->pending = 0;
+}
+
+void shader_release(ShaderProgram* shader) {
+    if (!shader || --shader->refs > 0) return;
+    if (shader->pending) finish(shader);
+    if (shader->program) {
+        glDeleteProgram(shader->program);
+        state_forget_program(shader->program);
+    }
+    shader->program = 0;
+}
+
+GLuint shader_program(ShaderProgram* shader) {
+    if (!shader) return 0;
+    if (shader->pending) finish(shader);
+    return shader->program;
+}
+
+GLuint shader_name(const ShaderProgram* shader) {
+    return shader ? shader->build.program : 0;
+}
+
+int shader_registry_poll(void) {
+    int pending = 0;
+    for (int i = 0; i < SHADER_REGISTRY_MAX; i++) {
+        ShaderProgram* p = &programs[i];
+        if (p->refs == 0 || !p->pending) continue;
+        if (shader_ready(&p->build)) finish(p);
+        else                         pending++;
+    }
+    return pending;
+}
+
+static GLint lookup(Location* cache, int* count, const char* name,
+                    GLuint program, GLint (*query)(GLuint, const GLchar*)) {
+    for (int i = 0; i < *count; i++) {
+        if (strcmp(cache[i].name, name) == 0) return cache[i].location;
+    }
+    GLint location = query(program, name);
+    // Names that do not fit are still answered, just not cached
+    if (*count < SHADER_MAX_LOCATIONS && strlen(name) < NAME_LENGTH) {
+        strcpy(cache[*count].name, name);
+        cache[*count].location = location;
+        (*count)++;
+    }
+    return location;
+}
+
+GLint shader_uniform_location(ShaderProgram* shader, const char* name) {
+    GLuint program = shader_program(shader);
+    if (!program) return -1;
+    return lookup(shader->uniforms, &shader->uniformCount, name, program, glGetUniformLocation);
+}
+
+GLint shader_attribute_location(ShaderProgram* shader, const char* name) {
+    GLuint program = shader_program(shader);
+    if (!program) return -1;
+    return lookup(shader->attributes, &shader->attributeCount, name, program, glGetAttribLocation);
+}
+
+void shader_registry_destroy(void) {
+    for (int i = 0; i < SHADER_REGISTRY_MAX; i++) {
+        if (programs[i].refs == 0) continue;
+        programs[i].refs = 1;
+        shader_release(&programs[i]);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef SHADER_REGISTRY_H
+#define SHADER_REGISTRY_H
+
+#include <stdint.h>
+#include <glad/glad.h>
+
+// ------------------------------------------------------------------
+// Shader registry (shader/registry.c):
+// programs are identified by a hash of their normalized sources
+// (comments and insignificant whitespace removed), so every caller
+// asking for the same shader gets the same refcounted program, linked
+// once. Uniform and attribute locations are looked up once per
+// program and cached.
+//
+// shader_acquire() only submits the build (see shader_submit()), so
+// a whole startup's worth of programs compiles in parallel where the
+// driver allows it. shader_registry_poll() finishes those the driver
+// is done with; shader_program() finishes one on the spot, blocking,
+// when it is needed before that.
+// ------------------------------------------------------------------
+#define SHADER_REGISTRY_MAX  32
+#define SHADER_MAX_LOCATIONS 16
+
+typedef struct ShaderProgram ShaderProgram;
+
+// The shared program for these sources, or NULL if the registry is full.
+ShaderProgram* shader_acquire(const char* vertex, const char* fragment);
+// Drops a reference; the program is deleted with the last one.
+void           shader_release(ShaderProgram* shader);
+// The linked program, or 0 if it failed to build.
+GLuint         shader_program(ShaderProgram* shader);
+// Its GL name without waiting for the build (to label it, not to use it).
+GLuint         shader_name(const ShaderProgram* shader);
+// Finishes every build the driver has completed; returns how many are
+// still compiling. Call once per frame.
+int            shader_registry_poll(void);
+
+// -1 if the program has no active variable of that name.
+GLint shader_uniform_location(ShaderProgram* shader, const char* name);
+GLint shader_attribute_location(ShaderProgram* shader, const char* name);
+
+// Deletes every program still registered (at shutdown).
+void shader_registry_destroy(void);
+
+// FNV-1a of the normalized sources; also the program binary cache key.
+uint64_t shader_source_hash(const char* vertex, const char* fragment);
+
+#endif // SHADER_REGISTRY_H
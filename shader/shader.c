@@ -1,53 +1,148 @@
 // shader.c
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <glad/glad.h>
+#include "../render/uniforms.h"
+#include "shader.h"
+#include "cache.h"
+#include "registry.h"
 
-GLuint compile_shader(GLenum shader_type, const char* src) {
-    GLuint shader = glCreateShader(shader_type);
+// KHR_parallel_shader_compile (ARB_ has the same values); not in our glad.
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR           0x91B1
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+static int parallel = 0;
+
+static int has_extension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0) return 1;
+    }
+    return 0;
+}
+
+int shader_parallel_init(GLADloadproc load) {
+    const char* function = NULL;
+    if (has_extension("GL_KHR_parallel_shader_compile")) {
+        function = "glMaxShaderCompilerThreadsKHR";
+    } else if (has_extension("GL_ARB_parallel_shader_compile")) {
+        function = "glMaxShaderCompilerThreadsARB";
+    }
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxThreads =
+        function ? (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load(function) : NULL;
+    if (!maxThreads) {
+        printf("shader: no parallel compile extension, programs finish on first use\n");
+        return -1;
+    }
+
+    // 0xFFFFFFFF lets the driver pick as many threads as it sees fit
+    maxThreads(0xFFFFFFFFu);
+    GLint threads = 0;
+    glGetIntegerv(GL_MAX_SHADER_COMPILER_THREADS_KHR, &threads);
+    // The value set is read back as is: 0xFFFFFFFF (-1) means "no limit"
+    if (threads < 0) printf("shader: parallel compile, driver threads unlimited\n");
+    else             printf("shader: parallel compile, up to %d driver threads\n", threads);
+    parallel = 1;
+    return 0;
+}
+
+static GLuint submit_stage(GLenum type, const char* src) {
+    GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &src, NULL);
     glCompileShader(shader);
+    return shader;
+}
+
+// Reports a failed stage; only called once the compile is known to be over.
+static int check_stage(GLuint shader, GLenum type) {
     GLint success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
         char log[512];
         glGetShaderInfoLog(shader, sizeof(log), NULL, log);
         fprintf(stderr, "Error shader %s compile:\n%s\n",
-                (shader_type == GL_VERTEX_SHADER ? "vertex" :
-                 shader_type == GL_FRAGMENT_SHADER ? "fragment" : "unknown"),
+                (type == GL_VERTEX_SHADER ? "vertex" :
+                 type == GL_FRAGMENT_SHADER ? "fragment" : "unknown"),
                 log);
-        glDeleteShader(shader);
-        return (GLuint)-1;
     }
-    return shader;
+    return success;
+}
+
+void shader_bind_blocks(GLuint program) {
+    // Blocks a program does not declare are simply skipped
+    GLuint frame = glGetUniformBlockIndex(program, "Frame");
+    if (frame != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, frame, UNIFORMS_FRAME_BINDING);
+    }
+    GLuint object = glGetUniformBlockIndex(program, "Object");
+    if (object != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, object, UNIFORMS_OBJECT_BINDING);
+    }
 }
 
-GLuint create_shader(char* vertex, char* fragment) {
-    GLuint shader_v = compile_shader(GL_VERTEX_SHADER,   vertex);
-    if (shader_v == (GLuint)-1) return (GLuint)-1;
-    GLuint shader_f = compile_shader(GL_FRAGMENT_SHADER, fragment);
-    if (shader_f == (GLuint)-1) {
-        glDeleteShader(shader_v);
-        return (GLuint)-1;
+void shader_submit(ShaderBuild* build, const char* vertex, const char* fragment, uint64_t key) {
+    memset(build, 0, sizeof(*build));
+    build->key = key;
+    build->program = shader_cache_load(key);
+    if (build->program) {
+        build->cached = 1;
+        return;
     }
 
-    GLuint program = glCreateProgram();
-    glAttachShader(program, shader_v);
-    glAttachShader(program, shader_f);
-    glLinkProgram(program);
+    // Compile and link are only queued here: no status is read back, so
+    // the driver is free to run them on its compiler threads meanwhile
+    build->vertex   = submit_stage(GL_VERTEX_SHADER,   vertex);
+    build->fragment = submit_stage(GL_FRAGMENT_SHADER, fragment);
+    build->program  = glCreateProgram();
+    glAttachShader(build->program, build->vertex);
+    glAttachShader(build->program, build->fragment);
+    shader_cache_prepare(build->program);
+    glLinkProgram(build->program);
+}
+
+int shader_ready(const ShaderBuild* build) {
+    if (build->cached || !parallel) return 1;
+    GLint done = GL_FALSE;
+    glGetProgramiv(build->program, GL_COMPLETION_STATUS_KHR, &done);
+    return done;
+}
+
+GLuint shader_finish(ShaderBuild* build) {
+    GLuint program = build->program;
+    if (build->cached) {
+        shader_bind_blocks(program);
+        return program;
+    }
 
+    // Blocks until the driver is done with this program
     GLint linked;
     glGetProgramiv(program, GL_LINK_STATUS, &linked);
     if (!linked) {
-        char log[512];
-        glGetProgramInfoLog(program, sizeof(log), NULL, log);
-        fprintf(stderr, "Error linking shader program:\n%s\n", log);
+        // The stage logs say more than the link log when a compile failed
+        if (check_stage(build->vertex, GL_VERTEX_SHADER)
+            && check_stage(build->fragment, GL_FRAGMENT_SHADER)) {
+            char log[512];
+            glGetProgramInfoLog(program, sizeof(log), NULL, log);
+            fprintf(stderr, "Error linking shader program:\n%s\n", log);
+        }
         glDeleteProgram(program);
-        program = (GLuint)-1;
+        program = 0;
+    } else {
+        shader_cache_store(program, build->key);
+        shader_bind_blocks(program);
     }
 
-    glDeleteShader(shader_v);
-    glDeleteShader(shader_f);
+    glDeleteShader(build->vertex);
+    glDeleteShader(build->fragment);
+    build->vertex = build->fragment = 0;
     return program;
 }
 
+GLuint create_shader(const char* vertex, const char* fragment) {
+    ShaderBuild build;
+    shader_submit(&build, vertex, fragment, shader_source_hash(vertex, fragment));
+    return shader_finish(&build);
+}
@@ -1,8 +1,39 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <stdint.h>
 #include <glad/glad.h>
 
-GLuint create_shader(char* vertex, char* fragment);
+// Compiles and links, or restores the program from the binary cache
+// (shader/cache.h) when one is open. Returns 0 on failure. Shapes
+// should go through shader_acquire() (shader/registry.h) instead, which
+// shares one program between identical sources.
+GLuint create_shader(const char* vertex, const char* fragment);
+// Points the "Frame" and "Object" uniform blocks of a linked program at
+// their fixed bindings (see render/uniforms.h). create_shader() does this.
+void shader_bind_blocks(GLuint program);
+
+// ------------------------------------------------------------------
+// Asynchronous builds: shader_submit() queues the compiles and the
+// link without reading any status back, shader_ready() asks the
+// driver (GL_COMPLETION_STATUS_KHR) whether it has finished, and
+// shader_finish() checks the result, blocking if it has not.
+// Without KHR_parallel_shader_compile every build reports ready and
+// the driver compiles at whichever of these calls it chooses.
+// ------------------------------------------------------------------
+typedef struct {
+    GLuint   program;
+    GLuint   vertex, fragment;
+    uint64_t key;      // shader_source_hash() of the sources
+    int      cached;   // restored from the binary cache, already linked
+} ShaderBuild;
+
+// Call once after the context exists, with the loader glad was given.
+// Returns -1 (and builds stay serial) without the extension.
+int    shader_parallel_init(GLADloadproc load);
+void   shader_submit(ShaderBuild* build, const char* vertex, const char* fragment, uint64_t key);
+int    shader_ready(const ShaderBuild* build);
+// The linked program, or 0 if it failed (the error is logged).
+GLuint shader_finish(ShaderBuild* build);
 
 #endif
@@ -0,0 +1,335 @@
+// shape/arena.c
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "../render/state.h"
+
+// -----------------------------------------------------------------------------
+// One VAO, one vertex buffer and one index buffer for every static mesh.
+//
+// Each buffer is carved up by a first-fit range allocator that keeps its free
+// blocks sorted by offset and merges neighbours on free. When a mesh does not
+// fit, the buffer doubles (copied GPU-side with glCopyBufferSubData). Holes
+// left by removed meshes are only reclaimed by arena_compact(), which copies
+// every live mesh into fresh, tightly packed buffers.
+//
+// Indices are stored relative to the mesh's first vertex, so moving a mesh
+// only changes its baseVertex/firstIndex – the index data is never rewritten.
+// -----------------------------------------------------------------------------
+
+#define VERTEX_BYTES (ARENA_VERTEX_FLOATS * (GLsizeiptr)sizeof(float))
+#define INDEX_BYTES  ((GLsizeiptr)sizeof(GLuint))
+
+typedef struct {
+    int offset;
+    int size;
+} Block;
+
+typedef struct {
+    Block* free;       // sorted by offset, never adjacent
+    int    freeCount;
+    int    freeCap;
+    int    capacity;   // in elements (vertices or indices)
+    int    used;
+} RangeAllocator;
+
+typedef struct {
+    int live;
+    int vertexOffset, vertexCount;
+    int indexOffset,  indexCount;
+} ArenaEntry;
+
+static GLuint vao = 0, vbo = 0, ibo = 0;
+static RangeAllocator vertexRanges, indexRanges;
+static ArenaEntry* entries = NULL;
+static int entryCount = 0, entryCap = 0;
+
+// ---- range allocator --------------------------------------------------------
+
+static int range_insert(RangeAllocator* r, int at, Block b) {
+    if (r->freeCount == r->freeCap) {
+        int cap = r->freeCap ? r->freeCap * 2 : 16;
+        Block* grown = realloc(r->free, sizeof(Block) * cap);
+        if (!grown) return -1;
+        r->free = grown;
+        r->freeCap = cap;
+    }
+    memmove(&r->free[at + 1], &r->free[at], sizeof(Block) * (r->freeCount - at));
+    r->free[at] = b;
+    r->freeCount++;
+    return 0;
+}
+
+static void range_remove_block(RangeAllocator* r, int at) {
+    memmove(&r->free[at], &r->free[at + 1], sizeof(Block) * (r->freeCount - at - 1));
+    r->freeCount--;
+}
+
+// Returns the offset of a `size`-element range, or -1 if nothing fits.
+static int range_alloc(RangeAllocator* r, int size) {
+    for (int i = 0; i < r->freeCount; i++) {
+        Block* b = &r->free[i];
+        if (b->size < size) continue;
+        int offset = b->offset;
+        b->offset += size;
+        b->size   -= size;
+        if (b->size == 0) range_remove_block(r, i);
+        r->used += size;
+        return offset;
+    }
+    return -1;
+}
+
+static void range_free(RangeAllocator* r, int offset, int size) {
+    if (size <= 0) return;
+    r->used -= size;
+
+    int at = 0;
+    while (at < r->freeCount && r->free[at].offset < offset) at++;
+
+    int mergePrev = at > 0 && r->free[at - 1].offset + r->free[at - 1].size == offset;
+    int mergeNext = at < r->freeCount && offset + size == r->free[at].offset;
+    if (mergePrev && mergeNext) {
+        r->free[at - 1].size += size + r->free[at].size;
+        range_remove_block(r, at);
+    } else if (mergePrev) {
+        r->free[at - 1].size += size;
+    } else if (mergeNext) {
+        r->free[at].offset = offset;
+        r->free[at].size  += size;
+    } else {
+        range_insert(r, at, (Block){ offset, size });
+    }
+}
+
+// Adds [capacity, newCapacity) as free space at the tail.
+static void range_grow(RangeAllocator* r, int newCapacity) {
+    int oldCapacity = r->capacity;
+    r->capacity = newCapacity;
+    r->used += newCapacity - oldCapacity;   // range_free subtracts it again
+    range_free(r, oldCapacity, newCapacity - oldCapacity);
+}
+
+// Everything below `used` is allocated, the rest is one free block.
+static void range_reset(RangeAllocator* r, int capacity, int used) {
+    r->capacity  = capacity;
+    r->used      = used;
+    r->freeCount = 0;
+    if (capacity > used) range_insert(r, 0, (Block){ used, capacity - used });
+}
+
+static int range_largest_free(const RangeAllocator* r) {
+    int largest = 0;
+    for (int i = 0; i < r->freeCount; i++) {
+        if (r->free[i].size > largest) largest = r->free[i].size;
+    }
+    return largest;
+}
+
+static float range_fragmentation(const RangeAllocator* r) {
+    int totalFree = r->capacity - r->used;
+    if (totalFree <= 0) return 0.0f;
+    return 1.0f - (float)range_largest_free(r) / (float)totalFree;
+}
+
+// ---- GL buffers -------------------------------------------------------------
+
+static void attach_buffers(void) {
+    state_bind_vertex_array(vao);
+    state_bind_buffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_BYTES, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_BYTES, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+}
+
+// The copy targets are never used for drawing, so buffers are created,
+// filled and copied through them without disturbing any other binding.
+static GLuint create_buffer(GLsizeiptr bytes) {
+    GLuint buf;
+    glGenBuffers(1, &buf);
+    state_bind_buffer(GL_COPY_WRITE_BUFFER, buf);
+    glBufferData(GL_COPY_WRITE_BUFFER, bytes, NULL, GL_STATIC_DRAW);
+    return buf;
+}
+
+static void delete_buffer(GLuint* buf) {
+    glDeleteBuffers(1, buf);
+    state_forget_buffer(*buf);
+    *buf = 0;
+}
+
+static void copy_buffer(GLuint src, GLintptr srcOffset,
+                        GLuint dst, GLintptr dstOffset, GLsizeiptr bytes) {
+    if (bytes <= 0) return;
+    state_bind_buffer(GL_COPY_READ_BUFFER,  src);
+    state_bind_buffer(GL_COPY_WRITE_BUFFER, dst);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                        srcOffset, dstOffset, bytes);
+}
+
+// Doubles `r` until a `size`-element block fits, moving `*buf` along.
+static int grow_until_fits(RangeAllocator* r, GLuint* buf, GLsizeiptr unit, int size) {
+    int offset;
+    while ((offset = range_alloc(r, size)) < 0) {
+        int newCapacity = r->capacity ? r->capacity * 2 : 1024;
+        GLuint bigger = create_buffer(newCapacity * unit);
+        copy_buffer(*buf, 0, bigger, 0, r->capacity * unit);
+        delete_buffer(buf);
+        *buf = bigger;
+        range_grow(r, newCapacity);
+        attach_buffers();
+    }
+    return offset;
+}
+
+// ---- public API -------------------------------------------------------------
+
+int arena_init(int vertexCapacity, int indexCapacity) {
+    arena_destroy();
+
+    glGenVertexArrays(1, &vao);
+    vbo = create_buffer(vertexCapacity * VERTEX_BYTES);
+    ibo = create_buffer(indexCapacity * INDEX_BYTES);
+    range_reset(&vertexRanges, vertexCapacity, 0);
+    range_reset(&indexRanges,  indexCapacity,  0);
+    attach_buffers();
+
+    // Welded meshes store each face's color on its first index, so flat
+    // varyings must take their value from the first vertex of a triangle.
+    glProvokingVertex(GL_FIRST_VERTEX_CONVENTION);
+    return glGetError() == GL_NO_ERROR ? 0 : -1;
+}
+
+void arena_destroy(void) {
+    if (vao) {
+        glDeleteVertexArrays(1, &vao);
+        state_forget_vertex_array(vao);
+    }
+    if (vbo) delete_buffer(&vbo);
+    if (ibo) delete_buffer(&ibo);
+    vao = 0;
+
+    free(vertexRanges.free);
+    free(indexRanges.free);
+    memset(&vertexRanges, 0, sizeof(vertexRanges));
+    memset(&indexRanges,  0, sizeof(indexRanges));
+    free(entries);
+    entries = NULL;
+    entryCount = entryCap = 0;
+}
+
+MeshId arena_add(const Mesh* mesh) {
+    if (!vao || mesh->stride != ARENA_VERTEX_FLOATS) {
+        fprintf(stderr, "arena_add: arena not initialised or unsupported vertex format\n");
+        return -1;
+    }
+
+    MeshId id = 0;
+    while (id < entryCount && entries[id].live) id++;
+    if (id == entryCap) {
+        int cap = entryCap ? entryCap * 2 : 16;
+        ArenaEntry* grown = realloc(entries, sizeof(ArenaEntry) * cap);
+        if (!grown) return -1;
+        entries = grown;
+        entryCap = cap;
+    }
+    if (id == entryCount) entryCount++;
+
+    ArenaEntry* e = &entries[id];
+    e->live         = 1;
+    e->vertexCount  = mesh->vertexCount;
+    e->indexCount   = mesh->indexCount;
+    e->vertexOffset = grow_until_fits(&vertexRanges, &vbo, VERTEX_BYTES, mesh->vertexCount);
+    e->indexOffset  = grow_until_fits(&indexRanges,  &ibo, INDEX_BYTES,  mesh->indexCount);
+
+    state_bind_buffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, e->vertexOffset * VERTEX_BYTES,
+                    mesh->vertexCount * VERTEX_BYTES, mesh->vertices);
+    state_bind_buffer(GL_COPY_WRITE_BUFFER, ibo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, e->indexOffset * INDEX_BYTES,
+                    mesh->indexCount * INDEX_BYTES, mesh->indices);
+    return id;
+}
+
+void arena_remove(MeshId id) {
+    if (id < 0 || id >= entryCount || !entries[id].live) return;
+    ArenaEntry* e = &entries[id];
+    range_free(&vertexRanges, e->vertexOffset, e->vertexCount);
+    range_free(&indexRanges,  e->indexOffset,  e->indexCount);
+    e->live = 0;
+}
+
+MeshRange arena_range(MeshId id) {
+    if (id < 0 || id >= entryCount || !entries[id].live) {
+        return (MeshRange){ 0, 0, 0 };
+    }
+    const ArenaEntry* e = &entries[id];
+    return (MeshRange){ e->vertexOffset, (GLuint)e->indexOffset, e->indexCount };
+}
+
+void arena_bind(void) {
+    state_bind_vertex_array(vao);
+}
+
+GLuint arena_vao(void) { return vao; }
+GLuint arena_vbo(void) { return vbo; }
+GLuint arena_ibo(void) { return ibo; }
+
+void arena_compact(void) {
+    if (!vao) return;
+
+    // glCopyBufferSubData forbids overlapping source and destination ranges
+    // in one buffer, so pack into new buffers instead of sliding in place.
+    GLuint packedVbo = create_buffer(vertexRanges.capacity * VERTEX_BYTES);
+    GLuint packedIbo = create_buffer(indexRanges.capacity  * INDEX_BYTES);
+    int vertexTop = 0, indexTop = 0;
+    for (int id = 0; id < entryCount; id++) {
+        ArenaEntry* e = &entries[id];
+        if (!e->live) continue;
+        copy_buffer(vbo, e->vertexOffset * VERTEX_BYTES,
+                    packedVbo, vertexTop * VERTEX_BYTES, e->vertexCount * VERTEX_BYTES);
+        copy_buffer(ibo, e->indexOffset * INDEX_BYTES,
+                    packedIbo, indexTop * INDEX_BYTES, e->indexCount * INDEX_BYTES);
+        e->vertexOffset = vertexTop;
+        e->indexOffset  = indexTop;
+        vertexTop += e->vertexCount;
+        indexTop  += e->indexCount;
+    }
+    while (entryCount > 0 && !entries[entryCount - 1].live) entryCount--;
+
+    delete_buffer(&vbo);
+    delete_buffer(&ibo);
+    vbo = packedVbo;
+    ibo = packedIbo;
+    range_reset(&vertexRanges, vertexRanges.capacity, vertexTop);
+    range_reset(&indexRanges,  indexRanges.capacity,  indexTop);
+    attach_buffers();
+}
+
+ArenaStats arena_stats(void) {
+    ArenaStats s;
+    s.meshes = 0;
+    for (int id = 0; id < entryCount; id++) s.meshes += entries[id].live;
+    s.vertexCapacity      = vertexRanges.capacity;
+    s.vertexUsed          = vertexRanges.used;
+    s.vertexLargestFree   = range_largest_free(&vertexRanges);
+    s.vertexFragmentation = range_fragmentation(&vertexRanges);
+    s.indexCapacity       = indexRanges.capacity;
+    s.indexUsed           = indexRanges.used;
+    s.indexLargestFree    = range_largest_free(&indexRanges);
+    s.indexFragmentation  = range_fragmentation(&indexRanges);
+    return s;
+}
+
+void arena_report(void) {
+    ArenaStats s = arena_stats();
+    printf("arena: %d meshes | vertices %d/%d (largest free %d, frag %.2f) | "
+           "indices %d/%d (largest free %d, frag %.2f)\n",
+           s.meshes,
+           s.vertexUsed, s.vertexCapacity, s.vertexLargestFree, s.vertexFragmentation,
+           s.indexUsed,  s.indexCapacity,  s.indexLargestFree,  s.indexFragmentation);
+}
@@ -0,0 +1,56 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <glad/glad.h>
+#include "mesh.h"
+
+// ------------------------------------------------------------------
+// Mesh arena (shape/arena.c):
+// every static mesh lives in one shared VBO + IBO behind one VAO.
+// Meshes are addressed by a MeshId that stays valid across growth
+// and compaction; the ranges it resolves to may move.
+//
+// Vertex format is fixed: vec3 position (location 0) + vec3 color
+// (location 1). The per-instance stream is attached to the same VAO
+// by the batch renderer (shape/batch.c).
+// ------------------------------------------------------------------
+#define ARENA_VERTEX_FLOATS 6
+
+typedef int MeshId;   // -1 = invalid
+
+typedef struct {
+    GLint   baseVertex;   // added to every index by glDraw*BaseVertex
+    GLuint  firstIndex;   // offset into the shared IBO, in indices
+    GLsizei indexCount;
+} MeshRange;
+
+typedef struct {
+    int   meshes;
+    int   vertexCapacity, vertexUsed, vertexLargestFree;
+    int   indexCapacity,  indexUsed,  indexLargestFree;
+    // 1 - largest free block / total free: 0 = all free space is one
+    // block, close to 1 = free space is shattered into small holes.
+    float vertexFragmentation;
+    float indexFragmentation;
+} ArenaStats;
+
+// Capacities are in vertices and indices; both grow on demand.
+int    arena_init(int vertexCapacity, int indexCapacity);
+void   arena_destroy(void);
+
+MeshId    arena_add(const Mesh* mesh);
+void      arena_remove(MeshId id);
+MeshRange arena_range(MeshId id);
+
+// Binds the shared VAO.
+void   arena_bind(void);
+GLuint arena_vao(void);
+GLuint arena_vbo(void);
+GLuint arena_ibo(void);
+
+// Packs all live meshes to the front of fresh buffers.
+void       arena_compact(void);
+ArenaStats arena_stats(void);
+void       arena_report(void);
+
+#endif // ARENA_H
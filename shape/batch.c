@@ -0,0 +1,245 @@
+// shape/batch.c
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "shape.h"
+#include "../bench/trace.h"
+#include "../core/frame.h"
+#include "../render/gpuprof.h"
+#include "../render/state.h"
+
+// -----------------------------------------------------------------------------
+// Frame-level draw batching.
+//
+// Submissions are bucketed by program (the only pipeline state that differs
+// between our shapes). Instance matrices from every submission are appended
+// to one CPU array, so a command's baseInstance is simply its offset into
+// that array; the per-instance attributes (divisor 1) start reading at
+// baseInstance for each draw.
+//
+// At flush time the instance array is uploaded once, the commands of each
+// bucket are laid out contiguously in the indirect buffer, and each bucket
+// becomes a single glMultiDrawElementsIndirect. Both uploads go through
+// StreamBuffers, so the base of this frame's instances in the ring is added
+// to every baseInstance and the draws read from the indirect ring's offset.
+// The command and instance arrays only ever grow, and the packed commands
+// are staged in the frame arena (core/frame.h), so a steady frame does no
+// allocation.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+    GLuint program;
+    int gpuScope;   // the bucket's draws in the GPU profile
+    DrawElementsIndirectCommand* cmds;
+    int count, cap;
+} Bucket;
+
+#define INITIAL_COMMANDS 64
+
+static InstanceBuffer instances;
+static StreamBuffer indirect;
+static int useMultiDraw = 0;
+
+static Bucket* buckets = NULL;
+static int bucketCount = 0, bucketCap = 0;
+
+static mat4* models = NULL;
+static int modelCount = 0, modelCap = 0;
+
+static BatchStats stats;
+static int flushScope = -1;
+
+// Grows *array to hold at least `need` elements of `size` bytes.
+static int reserve(void** array, int* cap, int need, size_t size) {
+    if (need <= *cap) return 0;
+    int newCap = *cap ? *cap : 64;
+    while (newCap < need) newCap *= 2;
+    void* grown = realloc(*array, size * newCap);
+    if (!grown) return -1;
+    *array = grown;
+    *cap = newCap;
+    return 0;
+}
+
+static Bucket* bucket_for(GLuint program) {
+    for (int i = 0; i < bucketCount; i++) {
+        if (buckets[i].program == program) return &buckets[i];
+    }
+    if (reserve((void**)&buckets, &bucketCap, bucketCount + 1, sizeof(Bucket)) != 0) {
+        return NULL;
+    }
+    Bucket* b = &buckets[bucketCount++];
+    memset(b, 0, sizeof(*b));
+    b->program = program;
+    char name[32];
+    snprintf(name, sizeof(name), "program %u", program);
+    b->gpuScope = gpuprof_scope(name);
+    return b;
+}
+
+void batch_name_program(GLuint program, const char* name) {
+    Bucket* b = bucket_for(program);
+    if (b) b->gpuScope = gpuprof_scope(name);
+}
+
+int batch_init(void) {
+    batch_destroy();
+    if (instance_buffer_init(&instances, arena_vao()) != 0) return -1;
+    flushScope = gpuprof_scope("batch");
+
+    // glMultiDrawElementsIndirect is core in 4.3 and needs baseInstance (4.2).
+    useMultiDraw = GLAD_GL_VERSION_4_3;
+    if (useMultiDraw
+        && stream_init(&indirect, GL_DRAW_INDIRECT_BUFFER,
+                       sizeof(DrawElementsIndirectCommand) * INITIAL_COMMANDS * 3,
+                       STREAM_AUTO) != 0) {
+        return -1;
+    }
+    printf("batch: %s, %s streaming\n",
+           useMultiDraw ? "glMultiDrawElementsIndirect"
+                        : "GL 3.3 fallback (one draw per command)",
+           stream_strategy_name(instances.stream.strategy));
+    return 0;
+}
+
+void batch_destroy(void) {
+    instance_buffer_destroy(&instances);
+    stream_destroy(&indirect);
+
+    for (int i = 0; i < bucketCount; i++) free(buckets[i].cmds);
+    free(buckets);
+    free(models);
+    buckets = NULL; models = NULL;
+    bucketCount = bucketCap = modelCount = modelCap = 0;
+}
+
+void batch_begin(void) {
+    // Buckets (and their command arrays) are kept for reuse; programs that
+    // are not submitted again this frame simply stay empty.
+    for (int i = 0; i < bucketCount; i++) buckets[i].count = 0;
+    modelCount = 0;
+    memset(&stats, 0, sizeof(stats));
+    stats.multiDraw = useMultiDraw;
+}
+
+void batch_add(GLuint program, MeshId mesh, const mat4* src, GLsizei count) {
+    MeshRange range = arena_range(mesh);
+    if (count <= 0 || range.indexCount == 0) return;
+
+    Bucket* b = bucket_for(program);
+    if (!b
+        || reserve((void**)&b->cmds, &b->cap, b->count + 1, sizeof(*b->cmds)) != 0
+        || reserve((void**)&models, &modelCap, modelCount + count, sizeof(mat4)) != 0) {
+        fprintf(stderr, "batch_add: out of memory, dropping %d instances\n", (int)count);
+        return;
+    }
+
+    b->cmds[b->count++] = (DrawElementsIndirectCommand){
+        .count         = (GLuint)range.indexCount,
+        .instanceCount = (GLuint)count,
+        .firstIndex    = range.firstIndex,
+        .baseVertex    = range.baseVertex,
+        .baseInstance  = (GLuint)modelCount,
+    };
+    memcpy(models[modelCount], src, sizeof(mat4) * count);
+    modelCount += count;
+
+    stats.commands++;
+    stats.instances += count;
+}
+
+static void flush_multidraw(GLuint base) {
+    int total = 0;
+    for (int i = 0; i < bucketCount; i++) total += buckets[i].count;
+    DrawElementsIndirectCommand* packed = frame_alloc(sizeof(*packed) * total);
+    if (!packed) return;
+
+    int at = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        for (int c = 0; c < buckets[i].count; c++) {
+            packed[at] = buckets[i].cmds[c];
+            packed[at].baseInstance += base;
+            at++;
+        }
+    }
+
+    GLsizeiptr bytes = (GLsizeiptr)total * sizeof(*packed);
+    if (bytes * 3 > indirect.capacity && stream_reserve(&indirect, bytes * 2) != 0) return;
+    // Leaves the ring bound to GL_DRAW_INDIRECT_BUFFER
+    GLintptr offset = stream_write(&indirect, packed, bytes, sizeof(GLuint));
+    if (offset < 0) {
+        fprintf(stderr, "batch_flush: indirect stream full, dropping %d commands\n", total);
+        return;
+    }
+
+    at = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        Bucket* b = &buckets[i];
+        if (b->count == 0) continue;
+        int scope = gpuprof_begin(b->gpuScope);
+        state_use_program(b->program);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (void*)(offset + at * sizeof(*packed)), b->count, 0);
+        gpuprof_end(scope);
+        at += b->count;
+        stats.glDrawCalls++;
+    }
+}
+
+static void flush_fallback(GLuint base) {
+    for (int i = 0; i < bucketCount; i++) {
+        Bucket* b = &buckets[i];
+        if (b->count == 0) continue;
+        int scope = gpuprof_begin(b->gpuScope);
+        state_use_program(b->program);
+        for (int c = 0; c < b->count; c++) {
+            const DrawElementsIndirectCommand* cmd = &b->cmds[c];
+            // No baseInstance before 4.2: move the instance stream instead
+            instance_buffer_set_base(&instances, base + cmd->baseInstance);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, cmd->count, GL_UNSIGNED_INT,
+                                              (void*)(cmd->firstIndex * sizeof(GLuint)),
+                                              cmd->instanceCount, cmd->baseVertex);
+            stats.glDrawCalls++;
+        }
+        gpuprof_end(scope);
+    }
+    instance_buffer_set_base(&instances, 0);
+}
+
+void batch_flush(void) {
+    if (modelCount == 0) return;
+
+    TRACE_ZONE("batch_flush");
+    int scope = gpuprof_begin(flushScope);
+    GLint base = instance_buffer_upload(&instances, (const mat4*)models, modelCount);
+    if (base < 0) {
+        fprintf(stderr, "batch_flush: instance stream full, dropping %d instances\n", modelCount);
+        gpuprof_end(scope);
+        return;
+    }
+    arena_bind();
+
+    for (int i = 0; i < bucketCount; i++) {
+        if (buckets[i].count > 0) stats.programs++;
+    }
+    if (useMultiDraw) flush_multidraw((GLuint)base);
+    else              flush_fallback((GLuint)base);
+
+    // Everything written this frame is now referenced by submitted draws
+    instance_buffer_fence(&instances);
+    if (useMultiDraw) stream_fence(&indirect);
+    gpuprof_end(scope);
+}
+
+BatchStats batch_stats(void) {
+    return stats;
+}
+
+void batch_report(FILE* out) {
+    fprintf(out, "batch: %d draws (%d instances) in %d GL draw calls for %d programs "
+                 "last frame, %s\n",
+            stats.commands, stats.instances, stats.glDrawCalls, stats.programs,
+            stats.multiDraw ? "multi-draw" : "one call per draw");
+}
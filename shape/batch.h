@@ -0,0 +1,54 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+#include <stdio.h>
+#include "arena.h"
+
+// ------------------------------------------------------------------
+// Batch renderer (shape/batch.c):
+// shapes submit (program, mesh, instances) during the frame; at
+// batch_flush() every draw is written into one indirect command
+// buffer and issued with one glMultiDrawElementsIndirect per program.
+// Without GL 4.3 the same commands are replayed one by one with
+// glDrawElementsInstancedBaseVertex.
+// ------------------------------------------------------------------
+
+// Layout fixed by GL for glMultiDrawElementsIndirect.
+typedef struct {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;
+} DrawElementsIndirectCommand;
+
+typedef struct {
+    int commands;     // draws submitted this frame
+    int instances;    // objects submitted this frame
+    int programs;     // distinct pipeline states
+    int glDrawCalls;  // draw calls actually issued by batch_flush()
+    int multiDraw;    // 1 if the glMultiDrawElementsIndirect path is active
+} BatchStats;
+
+// Call after arena_init(): the instance stream is attached to the arena VAO.
+int  batch_init(void);
+void batch_destroy(void);
+
+void batch_begin(void);
+// Queues `count` instances of `mesh` drawn with `program`. The models are
+// copied, so the caller may reuse its array immediately. Uniforms of
+// `program` are not captured: they must hold one value for the whole frame.
+void batch_add(GLuint program, MeshId mesh, const mat4* models, GLsizei count);
+void batch_flush(void);
+
+// Labels the draws of `program` in the GPU profile (default "program N").
+void batch_name_program(GLuint program, const char* name);
+
+// Counts of the frame since the last batch_begin().
+BatchStats batch_stats(void);
+// One line with batch_stats().
+void batch_report(FILE* out);
+
+#endif // BATCH_H
@@ -1,17 +1,25 @@
 // cube.c
-#include <SDL2/SDL.h>      // for SDL_GetTicks()
 #include <cglm/cglm.h>     // for mat4, glm_* helpers
 #include <stdio.h>
 #include <glad/glad.h>
-#include "../shader/shader.h"
+#include "../shader/registry.h"
+#include "shape.h"
+#include "mesh.h"
+#include "arena.h"
+#include "batch.h"
+#include "../render/state.h"
+#include "../render/uniforms.h"
+#include "../raster/raster.h"
 
 // ---- static state for the cube ----
-static GLuint cubeVAO = 0, cubeVBO = 0;
-static GLuint cubeProgram;
-static GLint  uMVP_loc;
+static MeshId cubeMesh = -1;   // range inside the shared mesh arena (or raster mesh id)
+static ShaderProgram* cubeShader = NULL;
 
 // CHANGED: replaced old indexed cube data with flat 36-vertex list,
 // so each face can be a single solid R, G or B color.
+// This is only the authoring form: init_cube() runs it through
+// mesh_build(), which welds it back into an indexed mesh and keeps the
+// solid faces by reading the color from the provoking vertex.
 static const float vertices[] = {
     // Face Z- (red) – all vertices use (1,0,0)
     -1,-1,-1,  1,0,0,
@@ -63,23 +71,27 @@ static const float vertices[] = {
 };
 
 void init_cube(void) {
-    // 1) Create VAO & VBO (unchanged)
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &cubeVBO);
-
-    glBindVertexArray(cubeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    // 1) Weld the flat list into an indexed, cache-ordered mesh
+    Mesh mesh;
+    if (mesh_build(vertices, sizeof(vertices) / (6 * sizeof(float)), 6,
+                   MESH_FLAT_ATTRIBS, &mesh) != 0) {
+        fprintf(stderr, "Failed to build cube mesh\n");
+        return;
+    }
+    mesh_report("cube", &mesh);
 
-    // 2) Set vertex attributes (unchanged layout, changed stride to 6 floats)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // Software backend: the rasterizer keeps its own copy, no GL involved
+    if (raster_active()) {
+        cubeMesh = raster_add_mesh(&mesh);
+        mesh_free(&mesh);
+        return;
+    }
 
-    glBindVertexArray(0);
+    // 2) Copy it into the shared arena VBO/IBO (arena_init() must run first)
+    cubeMesh = arena_add(&mesh);
+    mesh_free(&mesh);
     
-    glEnable(GL_DEPTH_TEST);
+    state_set_capability(GL_DEPTH_TEST, 1);
     //glEnable(GL_CULL_FACE);
     //glCullFace(GL_BACK);
     //glFrontFace(GL_CCW);
@@ -89,34 +101,54 @@ void init_cube(void) {
         "#version 330 core\n"
         "layout(location=0) in vec3 aPos;\n"
         "layout(location=1) in vec3 aColor;\n"
-        "uniform mat4 uMVP;\n"
-        "out vec3 vColor;\n"
+        "layout(location=2) in mat4 aModel;  // per instance\n"
+        UNIFORMS_FRAME_GLSL
+        "flat out vec3 vColor;  // per face, from the provoking vertex\n"
         "void main() {\n"
         "  vColor = aColor;\n"
-        "  gl_Position = uMVP * vec4(aPos,1.0);\n"
+        "  gl_Position = uViewProj * aModel * vec4(aPos,1.0);\n"
         "}\n";
     char *fs_src =
         "#version 330 core\n"
-        "in vec3 vColor;\n"
+        "flat in vec3 vColor;\n"
         "out vec4 outColor;\n"
         "void main() {\n"
         "  outColor = vec4(vColor,1.0);  // CHANGED: fully opaque\n"
         "}\n";
 
-    cubeProgram = create_shader(vs_src, fs_src);
-    if (!cubeProgram) {
+    // Only submitted here; it finishes compiling while the rest starts up
+    cubeShader = shader_acquire(vs_src, fs_src);
+    if (!cubeShader) {
         fprintf(stderr, "Failed to build cube shader program\n");
+        return;
+    }
+    batch_name_program(shader_name(cubeShader), "flat color");
+}
+
+void draw_cube_instanced(const mat4* models, GLsizei count) {
+    if (count <= 0) return;
+
+    if (raster_active()) {
+        raster_submit(cubeMesh, models, count);
+        return;
     }
 
-    // 4) Cache uniform location (unchanged)
-    uMVP_loc = glGetUniformLocation(cubeProgram, "uMVP");
+    // Waits for the compile if it is still running
+    GLuint program = shader_program(cubeShader);
+    if (!program) return;
+
+    // CHANGED: ensure no blending
+    state_set_capability(GL_BLEND, 0);
+
+    // The camera comes from the Frame uniform block, so there is nothing
+    // to upload here. Queued; drawn together with every other cube draw at batch_flush()
+    batch_add(program, cubeMesh, models, count);
 }
 
-void draw_cube(void) {
-    float t     = SDL_GetTicks() / 1000.0f;       
-    float angle = glm_rad(45.0f) * t;            
+void draw_cube(float spin) {
+    float angle = glm_rad(spin);
 
-    mat4 model, view, proj, tmp, mvp;
+    mat4 model;
     glm_mat4_identity(model);
 
     // CHANGED: tilt ~30° on X so you see three faces clearly
@@ -124,22 +156,6 @@ void draw_cube(void) {
     // CHANGED: then spin around Y
     glm_rotate(model, angle,          (vec3){0,1,0});
 
-    glm_mat4_identity(view);
-    glm_translate(view, (vec3){0,0,-5});  // camera back
-
-    glm_perspective(glm_rad(45.0f), 800.0f/600.0f, 0.1f, 100.0f, proj);
-
-    glm_mat4_mul(proj, view, tmp);
-    glm_mat4_mul(tmp,  model, mvp);
-
-    // CHANGED: ensure no blending
-    glDisable(GL_BLEND);
-    
-    glUseProgram(cubeProgram);
-    glUniformMatrix4fv(uMVP_loc, 1, GL_FALSE, (float*)mvp);
-    glBindVertexArray(cubeVAO);
-    // CHANGED: draw 36 vertices directly, no EBO
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+    // A single cube is just the instanced path with one instance
+    draw_cube_instanced(&model, 1);
 }
-
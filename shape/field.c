@@ -0,0 +1,190 @@
+// shape/field.c
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shape.h"
+#include "../core/frame.h"
+#include "../core/jobs.h"
+#include "../render/cull.h"
+#include "../render/transform.h"
+#include "../render/camera.h"
+
+// -----------------------------------------------------------------------------
+// A side x side grid of spinning cubes and pyramids (checkerboard pattern).
+// Every frame each shape's bounding spheres are culled against the camera
+// frustum, the model matrices of the survivors are rebuilt into one array per
+// shape by the batch transform kernel (render/transform.h), and each array is
+// submitted with a single instanced draw call.
+//
+// Culling and matrix building are split into chunks of FIELD_CHUNK objects
+// run by the job system (core/jobs.h). Chunk c writes its survivors from
+// slot c * FIELD_CHUNK on, so chunks never share output; the gaps are then
+// closed before the draw. The matrices are per-frame arrays from the frame
+// arena and each job keeps its survivors' indices in its scratch arena
+// (core/frame.h), so a frame allocates nothing.
+// -----------------------------------------------------------------------------
+
+#define FIELD_SPACING 0.5f
+#define FIELD_SCALE   0.15f
+// Both meshes fit in the unit cube, so this sphere holds them at any spin.
+#define FIELD_RADIUS  (FIELD_SCALE * 1.7320508f)
+#define FIELD_CHUNK   256   // a multiple of CULL_GROUP
+
+// Start angle of an object, so neighbours do not spin in lockstep, as the
+// y and w of a quaternion about Y: the frame's spin is composed onto it.
+typedef struct {
+    float y, w;
+} FieldPhase;
+
+static FieldPhase*  cubes     = NULL;
+static FieldPhase*  pyramids  = NULL;
+
+// Position, rotation and scale of every object, in the root's space
+static TransformSet cubeXforms, pyramidXforms;
+
+// World-space bounding spheres (the root transform never changes)
+static CullSet cubeBounds, pyramidBounds;
+
+static void field_root(mat4 root);
+
+void init_field(int side) {
+    close_field();
+    if (side <= 0) return;
+
+    int total = side * side;
+    cubes    = malloc(sizeof(FieldPhase) * (total / 2 + 1));
+    pyramids = malloc(sizeof(FieldPhase) * (total / 2 + 1));
+    if (!cubes || !pyramids) {
+        fprintf(stderr, "Failed to allocate field of %d objects\n", total);
+        close_field();
+        return;
+    }
+
+    mat4 root;
+    field_root(root);
+    transform_set_init(&cubeXforms);
+    transform_set_init(&pyramidXforms);
+    cull_set_init(&cubeBounds, CULL_SPHERES);
+    cull_set_init(&pyramidBounds, CULL_SPHERES);
+
+    float half = (side - 1) * FIELD_SPACING * 0.5f;
+    for (int z = 0; z < side; z++) {
+        for (int x = 0; x < side; x++) {
+            int isCube = !((x + z) & 1);
+            vec3 pos = { x * FIELD_SPACING - half, 0.0f, z * FIELD_SPACING - half };
+            float halfPhase = glm_rad((float)((x * 7 + z * 13) % 360)) * 0.5f;
+            versor rotation = { 0.0f, sinf(halfPhase), 0.0f, cosf(halfPhase) };
+
+            TransformSet* xforms = isCube ? &cubeXforms : &pyramidXforms;
+            int i = transform_set_add(xforms, pos, rotation,
+                                      (vec3){FIELD_SCALE, FIELD_SCALE, FIELD_SCALE});
+            vec4 center;
+            glm_mat4_mulv(root, (vec4){pos[0], pos[1], pos[2], 1.0f}, center);
+            if (i < 0 || cull_set_add_sphere(isCube ? &cubeBounds : &pyramidBounds,
+                                             center, FIELD_RADIUS) < 0) {
+                fprintf(stderr, "Failed to allocate field bounds\n");
+                close_field();
+                return;
+            }
+            (isCube ? cubes : pyramids)[i] = (FieldPhase){ rotation[1], rotation[3] };
+        }
+    }
+}
+
+// Root transform: push the grid away from the shapes' camera (which sits at
+// z = +5 looking down -Z) and tilt it towards the viewer.
+static void field_root(mat4 root) {
+    glm_mat4_identity(root);
+    glm_translate(root, (vec3){0.0f, -2.0f, -55.0f});
+    glm_rotate(root, glm_rad(35.0f), (vec3){1, 0, 0});
+}
+
+typedef struct {
+    const CullSet*    bounds;
+    TransformSet*     xforms;
+    const FieldPhase* phases;
+    mat4*             models;
+    int*              chunkVisible;   // survivors of each chunk
+    vec4*             planes;
+    float             spinY, spinW;   // the frame's spin as a quaternion about Y
+    mat4              root;
+} FieldUpdate;
+
+// Job: culls chunks [begin, end), then spins and builds their survivors
+static void update_chunks(void* data, int begin, int end) {
+    FieldUpdate* u = data;
+    LinearArena* scratch = frame_scratch();
+    LinearMark mark = linear_mark(scratch);
+    int* idx = linear_alloc(scratch, sizeof(int) * FIELD_CHUNK);
+    for (int c = begin; c < end; c++) {
+        int first = c * FIELD_CHUNK;
+        int count = u->bounds->count - first < FIELD_CHUNK ? u->bounds->count - first
+                                                           : FIELD_CHUNK;
+        int visible = idx ? cull_run_range(u->bounds, u->planes, first, count, idx) : 0;
+
+        // phase * spin, both about Y: the angles add up
+        for (int i = 0; i < visible; i++) {
+            const FieldPhase* p = &u->phases[idx[i]];
+            u->xforms->qy[idx[i]] = p->y * u->spinW + p->w * u->spinY;
+            u->xforms->qw[idx[i]] = p->w * u->spinW - p->y * u->spinY;
+        }
+        transform_build_indexed(u->xforms, idx, visible, u->root, u->models + first);
+        u->chunkVisible[c] = visible;
+    }
+    linear_release(scratch, mark);
+}
+
+// Updates every chunk of one shape; its survivors' matrices end up packed
+// at the start of *models (frame memory). Returns how many there are.
+static int update_shape(const CullSet* bounds, TransformSet* xforms, const FieldPhase* phases,
+                        vec4 planes[6], float spin, mat4** models) {
+    int chunks = (bounds->count + FIELD_CHUNK - 1) / FIELD_CHUNK;
+    FieldUpdate u = { .bounds = bounds, .xforms = xforms, .phases = phases,
+                      .models = frame_alloc(sizeof(mat4) * bounds->count),
+                      .chunkVisible = frame_alloc(sizeof(int) * chunks),
+                      .planes = planes,
+                      .spinY = sinf(glm_rad(spin) * 0.5f), .spinW = cosf(glm_rad(spin) * 0.5f) };
+    *models = u.models;
+    if (!u.models || !u.chunkVisible) {
+        fprintf(stderr, "Failed to allocate field frame arrays\n");
+        return 0;
+    }
+    field_root(u.root);
+    jobs_parallel_for(update_chunks, &u, chunks, 1);
+
+    int visible = 0;
+    for (int c = 0; c < chunks; c++) {
+        if (visible != c * FIELD_CHUNK) {
+            memmove(u.models + visible, u.models + c * FIELD_CHUNK,
+                    sizeof(mat4) * u.chunkVisible[c]);
+        }
+        visible += u.chunkVisible[c];
+    }
+    return visible;
+}
+
+void draw_field(float spin) {
+    if (!cubes) return;
+
+    vec4 planes[6];
+    memcpy(planes, camera_current()->planes, sizeof(planes));
+
+    mat4* models;
+    int visible = update_shape(&cubeBounds, &cubeXforms, cubes, planes, spin, &models);
+    draw_cube_instanced(models, visible);
+
+    visible = update_shape(&pyramidBounds, &pyramidXforms, pyramids, planes, spin, &models);
+    draw_triangle_instanced(models, visible);
+}
+
+void close_field(void) {
+    free(cubes);
+    free(pyramids);
+    transform_set_free(&cubeXforms);
+    transform_set_free(&pyramidXforms);
+    cull_set_free(&cubeBounds);
+    cull_set_free(&pyramidBounds);
+    cubes = pyramids = NULL;
+}
@@ -0,0 +1,77 @@
+// shape/instance.c
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+#include "shape.h"
+#include "../render/state.h"
+
+// -----------------------------------------------------------------------------
+// Per-instance transform stream shared by every instanced shape.
+//
+// Each instance is one column-major mat4 (the model matrix). A mat4 vertex
+// attribute takes four consecutive locations, so the stream occupies
+// locations SHAPE_INSTANCE_LOC .. SHAPE_INSTANCE_LOC+3, one vec4 column each,
+// with divisor 1 so the values advance once per instance instead of per vertex.
+//
+// The matrices live in a StreamBuffer. Every upload is mat4-aligned, so its
+// position in the ring is a whole instance index that the caller folds into
+// baseInstance; the attribute pointers themselves never move (except for the
+// GL 3.3 path, which has no baseInstance and uses instance_buffer_set_base).
+// -----------------------------------------------------------------------------
+
+#define INITIAL_INSTANCES 256
+
+// Points the four columns at instance `base` of the stream on the bound VAO.
+static void point_columns(const InstanceBuffer* ib, GLuint base) {
+    state_bind_buffer(GL_ARRAY_BUFFER, ib->stream.buffer);
+    for (int col = 0; col < 4; col++) {
+        GLuint loc = SHAPE_INSTANCE_LOC + col;
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(mat4),
+                              (void*)(base * sizeof(mat4) + col * sizeof(vec4)));
+    }
+}
+
+int instance_buffer_init(InstanceBuffer* ib, GLuint vao) {
+    ib->vao = vao;
+    if (stream_init(&ib->stream, GL_ARRAY_BUFFER,
+                    (GLsizeiptr)sizeof(mat4) * INITIAL_INSTANCES * 3, STREAM_AUTO) != 0) {
+        return -1;
+    }
+
+    state_bind_vertex_array(vao);
+    point_columns(ib, 0);
+    for (int col = 0; col < 4; col++) {
+        GLuint loc = SHAPE_INSTANCE_LOC + col;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    return 0;
+}
+
+void instance_buffer_set_base(const InstanceBuffer* ib, GLuint baseInstance) {
+    point_columns(ib, baseInstance);
+}
+
+GLint instance_buffer_upload(InstanceBuffer* ib, const mat4* models, GLsizei count) {
+    GLsizeiptr size = (GLsizeiptr)count * (GLsizeiptr)sizeof(mat4);
+
+    if (size * 3 > ib->stream.capacity) {
+        // Grow geometrically so a scene that slowly adds objects does not
+        // reallocate every frame. The new buffer needs the VAO re-pointed.
+        if (stream_reserve(&ib->stream, size * 2) != 0) return -1;
+        state_bind_vertex_array(ib->vao);
+        point_columns(ib, 0);
+    }
+
+    GLintptr offset = stream_write(&ib->stream, models, size, sizeof(mat4));
+    if (offset < 0) return -1;
+    return (GLint)(offset / (GLintptr)sizeof(mat4));
+}
+
+void instance_buffer_fence(InstanceBuffer* ib) {
+    stream_fence(&ib->stream);
+}
+
+void instance_buffer_destroy(InstanceBuffer* ib) {
+    stream_destroy(&ib->stream);
+    ib->vao = 0;
+}
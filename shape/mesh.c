@@ -0,0 +1,365 @@
+// shape/mesh.c
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+
+// -----------------------------------------------------------------------------
+// Mesh build stage. Takes the same flat "3 vertices per triangle" arrays the
+// shapes are authored in and produces an indexed mesh in three steps:
+//
+//   1) weld     – merge identical vertices. With MESH_FLAT_ATTRIBS only the
+//                 position has to match for non-provoking corners, because
+//                 the per-face attributes are read from the provoking vertex
+//                 (flat varyings, first-vertex convention).
+//   2) reorder  – Tipsify (Sander, Nehab & Barczak 2007): walk the mesh by
+//                 fanning around vertices that are still in the cache.
+//   3) remap    – renumber vertices in first-use order so the vertex fetch
+//                 walks the VBO front to back.
+// -----------------------------------------------------------------------------
+
+// ---- small open-addressing hash set over runs of floats ----------------------
+
+typedef struct {
+    int* slots;        // vertex index or -1
+    int  mask;
+} FloatHash;
+
+static unsigned hash_floats(const float* f, int n) {
+    const unsigned char* p = (const unsigned char*)f;
+    unsigned h = 2166136261u;                       // FNV-1a
+    for (size_t i = 0; i < n * sizeof(float); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static int float_hash_init(FloatHash* h, int count) {
+    int cap = 16;
+    while (cap < count * 2) cap *= 2;
+    h->slots = malloc(sizeof(int) * cap);
+    if (!h->slots) return -1;
+    memset(h->slots, 0xff, sizeof(int) * cap);
+    h->mask = cap - 1;
+    return 0;
+}
+
+// Looks up the `n` floats at `key`. Returns the stored index of an equal
+// key, or stores `index` and returns it if no equal key exists yet.
+// `base`/`stride` locate the float run of any stored index.
+static int float_hash_insert(FloatHash* h, const float* base, int stride,
+                             int n, const float* key, int index) {
+    unsigned slot = hash_floats(key, n) & h->mask;
+    while (h->slots[slot] >= 0) {
+        const float* other = base + (size_t)h->slots[slot] * stride;
+        if (memcmp(other, key, n * sizeof(float)) == 0) {
+            return h->slots[slot];
+        }
+        slot = (slot + 1) & h->mask;
+    }
+    h->slots[slot] = index;
+    return index;
+}
+
+// ---- 1) weld -----------------------------------------------------------------
+
+// Each output vertex copies its position from `posCorner` and its remaining
+// attributes from `attrCorner` (input corner indices). attrCorner == -1 means
+// no triangle uses this vertex as provoking vertex yet, so its attributes are
+// still free to be claimed.
+typedef struct {
+    int posCorner;
+    int attrCorner;
+    int next;          // next vertex sharing the same position, or -1
+} WeldVertex;
+
+static int weld_flat(const float* flat, int count, int stride,
+                     WeldVertex* verts, GLuint* indices) {
+    int* posId   = malloc(sizeof(int) * count);
+    int* posHead = malloc(sizeof(int) * count);
+    FloatHash hash = {0};
+    if (!posId || !posHead || float_hash_init(&hash, count) != 0) {
+        free(posId); free(posHead); free(hash.slots);
+        return -1;
+    }
+
+    for (int c = 0; c < count; c++) {
+        posId[c] = float_hash_insert(&hash, flat, stride, 3,
+                                     flat + (size_t)c * stride, c);
+        posHead[c] = -1;
+    }
+    free(hash.slots);
+
+    int attrFloats = stride - 3;
+    int numVerts = 0;
+    for (int t = 0; t < count / 3; t++) {
+        const float* attrs = flat + (size_t)(t * 3) * stride + 3;
+
+        // Pick the corner that can act as provoking vertex most cheaply:
+        // 0 = a vertex with these exact attributes already exists,
+        // 1 = a vertex at this position has unclaimed attributes,
+        // 2 = no vertex at this position yet, 3 = must duplicate one.
+        int bestCorner = 0, bestKind = 4, bestVert = -1;
+        for (int k = 0; k < 3; k++) {
+            int p = posId[t * 3 + k];
+            int kind = (posHead[p] < 0) ? 2 : 3;
+            int vert = -1;
+            for (int v = posHead[p]; v >= 0; v = verts[v].next) {
+                if (verts[v].attrCorner < 0) {
+                    if (kind > 1) { kind = 1; vert = v; }
+                } else if (memcmp(flat + (size_t)verts[v].attrCorner * stride + 3,
+                                  attrs, attrFloats * sizeof(float)) == 0) {
+                    kind = 0; vert = v;
+                    break;
+                }
+            }
+            if (kind < bestKind) {
+                bestKind = kind; bestCorner = k; bestVert = vert;
+            }
+        }
+
+        int prov = t * 3 + bestCorner;
+        if (bestKind == 1) {
+            verts[bestVert].attrCorner = t * 3;
+        } else if (bestKind >= 2) {
+            int p = posId[prov];
+            bestVert = numVerts++;
+            verts[bestVert] = (WeldVertex){ prov, t * 3, posHead[p] };
+            posHead[p] = bestVert;
+        }
+
+        // Provoking corner first; rotating keeps the winding order.
+        indices[t * 3] = (GLuint)bestVert;
+        for (int k = 1; k < 3; k++) {
+            int corner = t * 3 + (bestCorner + k) % 3;
+            int p = posId[corner];
+            if (posHead[p] < 0) {
+                verts[numVerts] = (WeldVertex){ corner, -1, -1 };
+                posHead[p] = numVerts++;
+            }
+            indices[t * 3 + k] = (GLuint)posHead[p];
+        }
+    }
+
+    // Vertices never used as provoking vertex: any attributes will do.
+    for (int v = 0; v < numVerts; v++) {
+        if (verts[v].attrCorner < 0) verts[v].attrCorner = verts[v].posCorner;
+    }
+
+    free(posId);
+    free(posHead);
+    return numVerts;
+}
+
+static int weld_exact(const float* flat, int count, int stride,
+                      WeldVertex* verts, GLuint* indices) {
+    FloatHash hash = {0};
+    if (float_hash_init(&hash, count) != 0) return -1;
+
+    int numVerts = 0;
+    int* remap = malloc(sizeof(int) * count);
+    if (!remap) { free(hash.slots); return -1; }
+
+    for (int c = 0; c < count; c++) {
+        int first = float_hash_insert(&hash, flat, stride, stride,
+                                      flat + (size_t)c * stride, c);
+        if (first == c) {
+            remap[c] = numVerts;
+            verts[numVerts++] = (WeldVertex){ c, c, -1 };
+        } else {
+            remap[c] = remap[first];
+        }
+        indices[c] = (GLuint)remap[c];
+    }
+    free(remap);
+    free(hash.slots);
+    return numVerts;
+}
+
+// ---- 2) Tipsify reorder -----------------------------------------------------
+
+static int tipsify(GLuint* indices, int indexCount, int vertexCount, int cacheSize) {
+    int triCount = indexCount / 3;
+    int* live     = calloc(vertexCount, sizeof(int));
+    int* adjStart = calloc(vertexCount + 1, sizeof(int));
+    int* adj      = malloc(sizeof(int) * indexCount);
+    int* stamp    = calloc(vertexCount, sizeof(int));
+    int* dead     = malloc(sizeof(int) * indexCount);     // dead-end stack
+    int* cand     = malloc(sizeof(int) * indexCount);
+    char* emitted = calloc(triCount, 1);
+    GLuint* out   = malloc(sizeof(GLuint) * indexCount);
+    int rc = -1;
+    if (!live || !adjStart || !adj || !stamp || !dead || !cand || !emitted || !out) {
+        goto done;
+    }
+
+    // Vertex → triangle adjacency (CSR layout).
+    for (int i = 0; i < indexCount; i++) live[indices[i]]++;
+    for (int v = 0; v < vertexCount; v++) adjStart[v + 1] = adjStart[v] + live[v];
+    {
+        int* fill = calloc(vertexCount, sizeof(int));
+        if (!fill) goto done;
+        for (int i = 0; i < indexCount; i++) {
+            int v = indices[i];
+            adj[adjStart[v] + fill[v]++] = i / 3;
+        }
+        free(fill);
+    }
+
+    int time = cacheSize + 1, deadTop = 0, cursor = 1, outCount = 0;
+    int fan = 0;
+    while (fan >= 0) {
+        int candCount = 0;
+        for (int a = adjStart[fan]; a < adjStart[fan + 1]; a++) {
+            int t = adj[a];
+            if (emitted[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                int v = indices[t * 3 + k];
+                out[outCount++] = (GLuint)v;
+                dead[deadTop++] = v;
+                cand[candCount++] = v;
+                live[v]--;
+                if (time - stamp[v] > cacheSize) stamp[v] = time++;
+            }
+            emitted[t] = 1;
+        }
+
+        // Next fanning vertex: the candidate that stays in the cache longest
+        // while still having triangles left to emit.
+        int next = -1, bestPriority = -1;
+        for (int c = 0; c < candCount; c++) {
+            int v = cand[c];
+            if (live[v] <= 0) continue;
+            int priority = 0;
+            if (time - stamp[v] + 2 * live[v] <= cacheSize) priority = time - stamp[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+        if (next < 0) {
+            // Dead end: back up through recently used vertices, then fall
+            // back to scanning input order.
+            while (deadTop > 0) {
+                int v = dead[--deadTop];
+                if (live[v] > 0) { next = v; break; }
+            }
+            while (next < 0 && cursor < vertexCount) {
+                if (live[cursor] > 0) next = cursor;
+                cursor++;
+            }
+        }
+        fan = next;
+    }
+
+    memcpy(indices, out, sizeof(GLuint) * indexCount);
+    rc = 0;
+done:
+    free(live); free(adjStart); free(adj); free(stamp);
+    free(dead); free(cand); free(emitted); free(out);
+    return rc;
+}
+
+// ---- metrics ----------------------------------------------------------------
+
+MeshCacheStats mesh_cache_stats(const GLuint* indices, int indexCount,
+                                int vertexCount, int cacheSize) {
+    MeshCacheStats stats = {0.0f, 0.0f};
+    if (indexCount < 3 || vertexCount <= 0) return stats;
+
+    // stamp[v] = position in the FIFO stream when v entered the cache
+    int* stamp = malloc(sizeof(int) * vertexCount);
+    if (!stamp) return stats;
+    for (int v = 0; v < vertexCount; v++) stamp[v] = -cacheSize - 1;
+
+    int misses = 0;
+    for (int i = 0; i < indexCount; i++) {
+        GLuint v = indices[i];
+        if (misses - stamp[v] > cacheSize) {
+            stamp[v] = misses++;
+        }
+    }
+    free(stamp);
+
+    stats.acmr = (float)misses / (float)(indexCount / 3);
+    stats.atvr = (float)misses / (float)vertexCount;
+    return stats;
+}
+
+// ---- public API -------------------------------------------------------------
+
+int mesh_build(const float* flat, int vertexCount, int stride, int flags, Mesh* out) {
+    memset(out, 0, sizeof(*out));
+    if (!flat || vertexCount < 3 || vertexCount % 3 != 0 || stride < 3) {
+        fprintf(stderr, "mesh_build: expected a triangle list of vec3-led vertices\n");
+        return -1;
+    }
+
+    WeldVertex* weld = malloc(sizeof(WeldVertex) * vertexCount);
+    GLuint* indices  = malloc(sizeof(GLuint) * vertexCount);
+    if (!weld || !indices) {
+        free(weld); free(indices);
+        return -1;
+    }
+
+    int numVerts = (flags & MESH_FLAT_ATTRIBS)
+                 ? weld_flat(flat, vertexCount, stride, weld, indices)
+                 : weld_exact(flat, vertexCount, stride, weld, indices);
+    if (numVerts < 0 || tipsify(indices, vertexCount, numVerts, MESH_CACHE_SIZE) != 0) {
+        free(weld); free(indices);
+        return -1;
+    }
+
+    // First-use order, so consecutive indices touch consecutive memory.
+    int* remap = malloc(sizeof(int) * numVerts);
+    float* verts = malloc(sizeof(float) * stride * numVerts);
+    if (!remap || !verts) {
+        free(weld); free(indices); free(remap); free(verts);
+        return -1;
+    }
+    memset(remap, 0xff, sizeof(int) * numVerts);
+    int next = 0;
+    for (int i = 0; i < vertexCount; i++) {
+        int v = indices[i];
+        if (remap[v] < 0) {
+            remap[v] = next;
+            float* dst = verts + (size_t)next * stride;
+            memcpy(dst,     flat + (size_t)weld[v].posCorner * stride,      3 * sizeof(float));
+            memcpy(dst + 3, flat + (size_t)weld[v].attrCorner * stride + 3,
+                   (stride - 3) * sizeof(float));
+            next++;
+        }
+        indices[i] = (GLuint)remap[v];
+    }
+    free(remap);
+    free(weld);
+
+    out->vertices    = verts;
+    out->indices     = indices;
+    out->vertexCount = next;
+    out->indexCount  = vertexCount;
+    out->stride      = stride;
+    // glDrawArrays on the flat list transforms every vertex exactly once.
+    out->before = (MeshCacheStats){ 3.0f, 1.0f };
+    out->after  = mesh_cache_stats(indices, vertexCount, next, MESH_CACHE_SIZE);
+    return 0;
+}
+
+void mesh_free(Mesh* mesh) {
+    free(mesh->vertices);
+    free(mesh->indices);
+    memset(mesh, 0, sizeof(*mesh));
+}
+
+void mesh_report(const char* name, const Mesh* mesh) {
+    int tris = mesh->indexCount / 3;
+    size_t flatBytes  = (size_t)mesh->indexCount * mesh->stride * sizeof(float);
+    size_t builtBytes = (size_t)mesh->vertexCount * mesh->stride * sizeof(float)
+                      + (size_t)mesh->indexCount * sizeof(GLuint);
+    printf("mesh %-8s %3d tris | vertices %d -> %d | bytes %zu -> %zu | "
+           "transforms %d -> %d | ACMR %.2f -> %.2f | ATVR %.2f -> %.2f\n",
+           name, tris, mesh->indexCount, mesh->vertexCount, flatBytes, builtBytes,
+           mesh->indexCount, (int)(mesh->after.acmr * tris + 0.5f),
+           mesh->before.acmr, mesh->after.acmr, mesh->before.atvr, mesh->after.atvr);
+}
@@ -0,0 +1,50 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <glad/glad.h>
+
+// ------------------------------------------------------------------
+// Mesh build stage (shape/mesh.c):
+// flat triangle list  →  deduplicated vertices + element buffer,
+// with triangles reordered for the post-transform vertex cache.
+//
+// Vertices are interleaved floats, `stride` floats each, and always
+// start with a vec3 position.
+// ------------------------------------------------------------------
+
+// Every attribute after the position is constant across each triangle
+// (solid per-face colors). Such attributes are read from the provoking
+// vertex through `flat` varyings, so vertices that only differ in those
+// attributes can be shared between faces.
+#define MESH_FLAT_ATTRIBS 0x1
+
+// FIFO size used by the reorder step and the reported metrics.
+#define MESH_CACHE_SIZE 16
+
+typedef struct {
+    float   acmr;   // average cache miss ratio: transformed vertices / triangle
+    float   atvr;   // average transform to vertex ratio: transformed / unique
+} MeshCacheStats;
+
+typedef struct {
+    float*  vertices;      // vertexCount * stride floats
+    GLuint* indices;       // indexCount indices, provoking vertex first
+    int     vertexCount;
+    int     indexCount;
+    int     stride;        // floats per vertex
+    MeshCacheStats before; // drawing the flat input with glDrawArrays
+    MeshCacheStats after;  // drawing the built mesh with glDrawElements
+} Mesh;
+
+// Returns 0 on success, -1 on failure (out is left zeroed).
+int  mesh_build(const float* flat, int vertexCount, int stride, int flags, Mesh* out);
+void mesh_free(Mesh* mesh);
+
+// Simulates a FIFO post-transform cache of `cacheSize` entries.
+MeshCacheStats mesh_cache_stats(const GLuint* indices, int indexCount,
+                                int vertexCount, int cacheSize);
+
+// One-line summary: vertex counts, bytes and ACMR/ATVR before → after.
+void mesh_report(const char* name, const Mesh* mesh);
+
+#endif // MESH_H
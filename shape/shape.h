@@ -2,24 +2,56 @@
 #define SHAPE_H
 
 #include <glad/glad.h>
+#include <cglm/cglm.h>
+#include "../render/stream.h"
 
 // ------------------------------------------------------------------
-// Cube functions (already existing):
+// Per-instance transform stream (shape/instance.c):
+// one mat4 model matrix per instance, bound to attribute locations
+// SHAPE_INSTANCE_LOC .. SHAPE_INSTANCE_LOC + 3 with divisor 1.
 // ------------------------------------------------------------------
-void init_cube(void);
-void draw_cube(void);
+#define SHAPE_INSTANCE_LOC 2
+
+typedef struct {
+    StreamBuffer stream;
+    GLuint       vao;      // VAO whose instance attributes point into stream
+} InstanceBuffer;
+
+int  instance_buffer_init(InstanceBuffer* ib, GLuint vao);
+// Streams `count` matrices and returns the instance index of the first one
+// (add it to baseInstance), or -1 on failure. Call instance_buffer_fence()
+// once the draws using them are submitted.
+GLint instance_buffer_upload(InstanceBuffer* ib, const mat4* models, GLsizei count);
+void instance_buffer_fence(InstanceBuffer* ib);
+// Emulates baseInstance on GL < 4.2: re-points the stream of the bound VAO
+// so instance 0 reads the model matrix stored at `baseInstance`.
+void instance_buffer_set_base(const InstanceBuffer* ib, GLuint baseInstance);
+void instance_buffer_destroy(InstanceBuffer* ib);
 
-// *** MODIFIED ***
-// Export the cube’s shader handle and its uMVP uniform location, so
-// triangle.c can reuse exactly the same shader:
-extern GLuint cubeProgram;
-extern GLint  cube_uMVP_loc;
+// ------------------------------------------------------------------
+// Cube functions (already existing). The draw functions only queue
+// work: call them between batch_begin() and batch_flush(). `spin` is
+// the simulated rotation about Y in degrees (SimState, sim/sim.h).
+// ------------------------------------------------------------------
+void init_cube(void);
+void draw_cube(float spin);
+// Queue `count` cubes for the frame's batch, one model matrix per cube.
+void draw_cube_instanced(const mat4* models, GLsizei count);
 
 // ------------------------------------------------------------------
 // Triangle/Pyramid functions (renamed from “pyramid” to match your code):
 // ------------------------------------------------------------------
 void init_triangle(void);
-void draw_triangle(void);
+void draw_triangle(float spin);
+// Queue `count` pyramids for the frame's batch, one model matrix per pyramid.
+void draw_triangle_instanced(const mat4* models, GLsizei count);
 
-#endif // SHAPE_H
+// ------------------------------------------------------------------
+// Field scene (shape/field.c): a side x side grid of spinning cubes
+// and pyramids, submitted as one instanced draw per shape.
+// ------------------------------------------------------------------
+void init_field(int side);
+void draw_field(float spin);
+void close_field(void);
 
+#endif // SHAPE_H
@@ -0,0 +1,30 @@
+// sim/clock.c
+#include <SDL2/SDL.h>
+#include "clock.h"
+
+void frame_clock_init(FrameClock* clock, double step) {
+    clock->step = step;
+    clock->accumulator = 0.0;
+    clock->last = SDL_GetPerformanceCounter();
+}
+
+double frame_clock_elapsed(FrameClock* clock) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double seconds = (double)(now - clock->last) / (double)SDL_GetPerformanceFrequency();
+    clock->last = now;
+    return seconds > FRAME_CLOCK_MAX_FRAME ? FRAME_CLOCK_MAX_FRAME : seconds;
+}
+
+int frame_clock_advance(FrameClock* clock, double seconds) {
+    clock->accumulator += seconds;
+    int steps = 0;
+    while (clock->accumulator >= clock->step) {
+        clock->accumulator -= clock->step;
+        steps++;
+    }
+    return steps;
+}
+
+float frame_clock_alpha(const FrameClock* clock) {
+    return (float)(clock->accumulator / clock->step);
+}
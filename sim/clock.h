@@ -0,0 +1,34 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <SDL2/SDL.h>
+
+// ------------------------------------------------------------------
+// Fixed-timestep frame clock (sim/clock.c):
+// elapsed time is read from SDL_GetPerformanceCounter() and piled into
+// an accumulator that the simulation drains in steps of exactly `step`
+// seconds. What is left over (less than one step) is how far rendering
+// is between the last two simulated states: frame_clock_alpha().
+// ------------------------------------------------------------------
+
+// A frame that took longer than this (a breakpoint, a stall, a long
+// idle wait) is simulated as if it had taken this long, so the
+// simulation never has to run hundreds of steps to catch up.
+#define FRAME_CLOCK_MAX_FRAME 0.25
+
+typedef struct {
+    double step;          // seconds per simulation step
+    double accumulator;   // seconds not simulated yet
+    Uint64 last;          // counter at the previous frame_clock_elapsed()
+} FrameClock;
+
+void   frame_clock_init(FrameClock* clock, double step);
+// Real seconds since the previous call (or init), clamped to
+// FRAME_CLOCK_MAX_FRAME.
+double frame_clock_elapsed(FrameClock* clock);
+// Adds `seconds` and returns how many steps the simulation must run.
+int    frame_clock_advance(FrameClock* clock, double seconds);
+// In [0, 1): weight of the newest state when interpolating.
+float  frame_clock_alpha(const FrameClock* clock);
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,28 @@
+// sim/sim.c
+#include <math.h>
+#include "sim.h"
+
+#define SPIN_SPEED 45.0   // degrees per second
+
+void sim_init(SimState* state) {
+    state->time = 0.0;
+    state->spin = 0.0f;
+}
+
+void sim_step(SimState* state, double dt) {
+    state->time += dt;
+    // Kept wrapped: a float angle that grows forever loses precision
+    state->spin = (float)fmod(state->spin + SPIN_SPEED * dt, 360.0);
+}
+
+void sim_lerp(const SimState* from, const SimState* to, float alpha, SimState* out) {
+    out->time = from->time + (to->time - from->time) * alpha;
+
+    // Interpolate across the wrap (350° -> 5° goes through 360°)
+    float delta = to->spin - from->spin;
+    if (delta < -180.0f) delta += 360.0f;
+    else if (delta > 180.0f) delta -= 360.0f;
+    out->spin = from->spin + delta * alpha;
+    if (out->spin >= 360.0f) out->spin -= 360.0f;
+    else if (out->spin < 0.0f) out->spin += 360.0f;
+}
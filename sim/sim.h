@@ -0,0 +1,23 @@
+#ifndef SIM_H
+#define SIM_H
+
+// ------------------------------------------------------------------
+// Scene simulation (sim/sim.c):
+// everything that moves, advanced in fixed steps of SIM_STEP seconds
+// (see sim/clock.h). Rendering never reads a simulated state directly
+// but sim_lerp() of the last two, so motion stays smooth whether
+// frames come faster or slower than steps.
+// ------------------------------------------------------------------
+#define SIM_STEP (1.0 / 60.0)
+
+typedef struct {
+    double time;   // simulated seconds
+    float  spin;   // shapes' rotation about Y, degrees in [0, 360)
+} SimState;
+
+void sim_init(SimState* state);
+void sim_step(SimState* state, double dt);
+// `alpha` = 0 gives `from`, 1 gives `to`.
+void sim_lerp(const SimState* from, const SimState* to, float alpha, SimState* out);
+
+#endif // SIM_H
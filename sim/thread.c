@@ -0,0 +1,124 @@
+// sim/thread.c
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include "thread.h"
+#include "clock.h"
+#include "triple.h"
+#include "../bench/trace.h"
+
+static TripleBuffer snapshots;
+static SDL_Thread*  thread = NULL;
+static SDL_atomic_t quit;
+static double       stepSeconds;
+static SimSnapshot  initial;
+// sim_thread_pause(): the thread waits on `wake` while `paused`
+static SDL_mutex*   lock = NULL;
+static SDL_cond*    wake = NULL;
+static int          paused = 0;
+
+// Blocks while paused; returns 1 if it did, so the caller restarts its
+// clock instead of simulating the pause.
+static int wait_while_paused(void) {
+    int waited = 0;
+    SDL_LockMutex(lock);
+    while (paused && !SDL_AtomicGet(&quit)) {
+        SDL_CondWait(wake, lock);
+        waited = 1;
+    }
+    SDL_UnlockMutex(lock);
+    return waited;
+}
+
+static int sim_main(void* data) {
+    (void)data;
+    trace_thread_name("sim");
+    SimSnapshot state = initial;
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    FrameClock clock;
+    frame_clock_init(&clock, stepSeconds);
+
+    while (!SDL_AtomicGet(&quit)) {
+        if (wait_while_paused()) frame_clock_init(&clock, stepSeconds);
+        int steps = frame_clock_advance(&clock, frame_clock_elapsed(&clock));
+        if (steps > 0) {
+            TRACE_ZONE("sim step");
+            for (int i = 0; i < steps; i++) {
+                state.previous = state.current;
+                sim_step(&state.current, stepSeconds);
+            }
+            // The last step was due when the leftover time began
+            state.stamp = clock.last
+                        - (Uint64)(frame_clock_alpha(&clock) * stepSeconds * (double)freq);
+            *(SimSnapshot*)triple_back(&snapshots) = state;
+            triple_publish(&snapshots);
+        }
+        // Sleep until the next step is due; rounded up, since waking
+        // early would spin on SDL_Delay(0) for the rest of the step
+        double ms = (1.0 - frame_clock_alpha(&clock)) * stepSeconds * 1000.0;
+        SDL_Delay(ms > 1.0 ? (Uint32)ceil(ms) : 1);
+    }
+    return 0;
+}
+
+int sim_thread_start(double step) {
+    if (triple_init(&snapshots, sizeof(SimSnapshot)) != 0) return -1;
+    stepSeconds = step;
+
+    // Published before the thread exists, so the reader always has one
+    sim_init(&initial.current);
+    initial.previous = initial.current;
+    initial.stamp = SDL_GetPerformanceCounter();
+    *(SimSnapshot*)triple_back(&snapshots) = initial;
+    triple_publish(&snapshots);
+
+    SDL_AtomicSet(&quit, 0);
+    paused = 0;
+    lock = SDL_CreateMutex();
+    wake = SDL_CreateCond();
+    thread = lock && wake ? SDL_CreateThread(sim_main, "sim", NULL) : NULL;
+    if (!thread) {
+        fprintf(stderr, "sim: cannot start thread: %s\n", SDL_GetError());
+        if (wake) SDL_DestroyCond(wake);
+        if (lock) SDL_DestroyMutex(lock);
+        wake = NULL;
+        lock = NULL;
+        triple_destroy(&snapshots);
+        return -1;
+    }
+    return 0;
+}
+
+void sim_thread_stop(void) {
+    if (!thread) return;
+    SDL_LockMutex(lock);
+    SDL_AtomicSet(&quit, 1);
+    SDL_CondSignal(wake);
+    SDL_UnlockMutex(lock);
+    SDL_WaitThread(thread, NULL);
+    thread = NULL;
+    SDL_DestroyCond(wake);
+    SDL_DestroyMutex(lock);
+    wake = NULL;
+    lock = NULL;
+    triple_destroy(&snapshots);
+}
+
+void sim_thread_pause(int pause) {
+    pause = pause != 0;
+    if (!thread || pause == paused) return;   // only this thread writes it
+    SDL_LockMutex(lock);
+    paused = pause;
+    if (!paused) SDL_CondSignal(wake);
+    SDL_UnlockMutex(lock);
+}
+
+void sim_thread_view(SimState* out) {
+    const SimSnapshot* s = triple_front(&snapshots);
+    Uint64 now = SDL_GetPerformanceCounter();
+    double alpha = now > s->stamp
+                 ? (double)(now - s->stamp) / ((double)SDL_GetPerformanceFrequency() * stepSeconds)
+                 : 0.0;
+    // Past 1 the thread is late: hold the newest state rather than guess
+    sim_lerp(&s->previous, &s->current, alpha < 1.0 ? (float)alpha : 1.0f, out);
+}
@@ -0,0 +1,33 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <SDL2/SDL.h>
+#include "sim.h"
+
+// ------------------------------------------------------------------
+// Simulation thread (sim/thread.c):
+// steps the SimState in real time on its own thread, with a
+// FrameClock, and publishes after each batch of steps an immutable
+// snapshot of the last two states through a triple buffer
+// (sim/triple.h). The render thread never waits for it: it takes the
+// newest snapshot and interpolates by how long ago it was stepped, so
+// the next steps are simulated while the current frame renders.
+// While paused the thread sleeps on a condition variable and does not
+// step; it resumes from the state it stopped at.
+// ------------------------------------------------------------------
+
+typedef struct {
+    SimState previous, current;
+    Uint64   stamp;   // performance counter when `current` was due
+} SimSnapshot;
+
+int  sim_thread_start(double step);
+void sim_thread_stop(void);
+// Parks or resumes the thread (main thread only). Call with 1 while
+// nothing is drawn, so an idle window costs no CPU.
+void sim_thread_pause(int pause);
+
+// The state to render now. Never blocks.
+void sim_thread_view(SimState* out);
+
+#endif // SIM_THREAD_H
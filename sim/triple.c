@@ -0,0 +1,45 @@
+// sim/triple.c
+#include <stdlib.h>
+#include "triple.h"
+
+int triple_init(TripleBuffer* tb, size_t size) {
+    for (int i = 0; i < 3; i++) {
+        // Separate allocations keep the slots off each other's cache lines
+        tb->slots[i] = calloc(1, size);
+        if (!tb->slots[i]) {
+            triple_destroy(tb);
+            return -1;
+        }
+    }
+    tb->front = 0;
+    atomic_init(&tb->middle, 1);
+    tb->back = 2;
+    return 0;
+}
+
+void triple_destroy(TripleBuffer* tb) {
+    for (int i = 0; i < 3; i++) {
+        free(tb->slots[i]);
+        tb->slots[i] = NULL;
+    }
+}
+
+void* triple_back(TripleBuffer* tb) {
+    return tb->slots[tb->back];
+}
+
+void triple_publish(TripleBuffer* tb) {
+    // Release: the snapshot is written before the reader can take it.
+    // Acquire: the slot we get back is one the reader has let go of.
+    int old = atomic_exchange_explicit(&tb->middle, tb->back | TRIPLE_FRESH,
+                                       memory_order_acq_rel);
+    tb->back = old & ~TRIPLE_FRESH;
+}
+
+const void* triple_front(TripleBuffer* tb) {
+    if (atomic_load_explicit(&tb->middle, memory_order_relaxed) & TRIPLE_FRESH) {
+        int old = atomic_exchange_explicit(&tb->middle, tb->front, memory_order_acq_rel);
+        tb->front = old & ~TRIPLE_FRESH;
+    }
+    return tb->slots[tb->front];
+}
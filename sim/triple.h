@@ -0,0 +1,37 @@
+#ifndef SIM_TRIPLE_H
+#define SIM_TRIPLE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+// ------------------------------------------------------------------
+// Lock-free triple buffer (sim/triple.c):
+// one writer and one reader exchange fixed-size snapshots without
+// ever waiting for each other. The writer fills its back slot and
+// swaps it with the middle one; the reader swaps its front slot with
+// the middle one only when that holds something it has not seen.
+// Each side then owns its slot exclusively until its next swap, so
+// the reader always sees a complete snapshot: the newest published
+// one, and snapshots published in between are simply skipped.
+// ------------------------------------------------------------------
+#define TRIPLE_FRESH 4   // set in `middle` while it holds an unread snapshot
+
+typedef struct {
+    void*      slots[3];
+    atomic_int middle;   // slot index | TRIPLE_FRESH
+    int        back;     // the writer's slot
+    int        front;    // the reader's slot
+} TripleBuffer;
+
+// Slots are zeroed; publish once before the reader starts.
+int  triple_init(TripleBuffer* tb, size_t size);
+void triple_destroy(TripleBuffer* tb);
+
+// Writer: the slot to fill, then hand it over.
+void* triple_back(TripleBuffer* tb);
+void  triple_publish(TripleBuffer* tb);
+
+// Reader: the newest published snapshot, valid until the next call.
+const void* triple_front(TripleBuffer* tb);
+
+#endif // SIM_TRIPLE_H
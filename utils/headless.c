@@ -0,0 +1,194 @@
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "headless.h"
+#include "../render/state.h"
+
+static EGLDisplay gDisplay = EGL_NO_DISPLAY;
+static EGLContext gContext = EGL_NO_CONTEXT;
+static EGLSurface gSurface = EGL_NO_SURFACE;
+static GLuint gFbo = 0;
+static GLuint gRenderbuffers[2] = {0, 0};
+static int gWidth = 0, gHeight = 0;
+
+static int hasExtension(const char* list, const char* name) {
+    size_t len = strlen(name);
+    while (list && (list = strstr(list, name))) {
+        if (list[len] == ' ' || list[len] == '\0') return 1;
+        list += len;
+    }
+    return 0;
+}
+
+// Prefers the surfaceless platform (no X11/Wayland needed at all),
+// otherwise the default display.
+static EGLDisplay openDisplay() {
+    const char* clientExt = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExt, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            EGLDisplay d = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                              EGL_DEFAULT_DISPLAY, NULL);
+            if (d != EGL_NO_DISPLAY) return d;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+static int createFramebuffer(int width, int height) {
+    glGenFramebuffers(1, &gFbo);
+    glGenRenderbuffers(2, gRenderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, gRenderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, gRenderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, gFbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, gRenderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, gRenderbuffers[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        SDL_Log("Headless framebuffer incomplete");
+        return -1;
+    }
+    glViewport(0, 0, width, height);
+    return 0;
+}
+
+int initHeadless(int width, int height) {
+    // Timers only: no video subsystem, so no display server is needed
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        SDL_Log("SDL init timer fail, %s", SDL_GetError());
+        return -1;
+    }
+
+    gDisplay = openDisplay();
+    EGLint major, minor;
+    if (gDisplay == EGL_NO_DISPLAY || !eglInitialize(gDisplay, &major, &minor)) {
+        SDL_Log("EGL init fail: 0x%x", eglGetError());
+        closeHeadless();
+        return -1;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        SDL_Log("EGL has no desktop GL: 0x%x", eglGetError());
+        closeHeadless();
+        return -1;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(gDisplay, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        SDL_Log("EGL has no pbuffer config: 0x%x", eglGetError());
+        closeHeadless();
+        return -1;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    gContext = eglCreateContext(gDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (gContext == EGL_NO_CONTEXT) {
+        SDL_Log("EGL create context fail: 0x%x", eglGetError());
+        closeHeadless();
+        return -1;
+    }
+
+    // The FBO is the real target, so a surface is only needed when the
+    // driver cannot make a context current without one.
+    const char* displayExt = eglQueryString(gDisplay, EGL_EXTENSIONS);
+    if (!hasExtension(displayExt, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        gSurface = eglCreatePbufferSurface(gDisplay, config, pbufferAttribs);
+        if (gSurface == EGL_NO_SURFACE) {
+            SDL_Log("EGL pbuffer fail: 0x%x", eglGetError());
+            closeHeadless();
+            return -1;
+        }
+    }
+    if (!eglMakeCurrent(gDisplay, gSurface, gSurface, gContext)) {
+        SDL_Log("EGL make current fail: 0x%x", eglGetError());
+        closeHeadless();
+        return -1;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        SDL_Log("Failed to init glad");
+        closeHeadless();
+        return -1;
+    }
+    if (createFramebuffer(width, height) != 0) {
+        closeHeadless();
+        return -1;
+    }
+    gWidth = width;
+    gHeight = height;
+    SDL_Log("Headless GL: EGL %d.%d, %s, %s", major, minor,
+            gSurface == EGL_NO_SURFACE ? "surfaceless" : "pbuffer",
+            (const char*)glGetString(GL_RENDERER));
+    return 0;
+}
+
+void getHeadlessSize(int* width, int* height) {
+    *width = gWidth;
+    *height = gHeight;
+}
+
+void* getHeadlessProcAddress(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
+
+int saveHeadlessFrame(const char* path) {
+    unsigned char* pixels = malloc((size_t)gWidth * gHeight * 3);
+    FILE* file = pixels ? fopen(path, "wb") : NULL;
+    if (!file) {
+        SDL_Log("Cannot write %s", path);
+        free(pixels);
+        return -1;
+    }
+
+    state_bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, gWidth, gHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+
+    // GL rows start at the bottom, PPM rows at the top
+    fprintf(file, "P6\n%d %d\n255\n", gWidth, gHeight);
+    for (int y = gHeight - 1; y >= 0; y--) {
+        fwrite(pixels + (size_t)y * gWidth * 3, 1, (size_t)gWidth * 3, file);
+    }
+    fclose(file);
+    free(pixels);
+    return 0;
+}
+
+void closeHeadless() {
+    if (gFbo) {
+        glDeleteFramebuffers(1, &gFbo);
+        glDeleteRenderbuffers(2, gRenderbuffers);
+        gFbo = 0;
+    }
+    if (gDisplay != EGL_NO_DISPLAY) {
+        eglMakeCurrent(gDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (gContext != EGL_NO_CONTEXT) eglDestroyContext(gDisplay, gContext);
+        if (gSurface != EGL_NO_SURFACE) eglDestroySurface(gDisplay, gSurface);
+        eglTerminate(gDisplay);
+    }
+    gDisplay = EGL_NO_DISPLAY;
+    gContext = EGL_NO_CONTEXT;
+    gSurface = EGL_NO_SURFACE;
+    SDL_Quit();
+}
@@ -0,0 +1,20 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// ------------------------------------------------------------------
+// Headless GL (utils/headless.c):
+// a GL 3.3 core context from EGL with no window and no display
+// server (Mesa's surfaceless platform, or a 1x1 pbuffer where that
+// is missing), rendering into an FBO that stays bound as the draw
+// framebuffer. Everything after initGL() works unchanged.
+// ------------------------------------------------------------------
+
+int  initHeadless(int width, int height);
+void getHeadlessSize(int* width, int* height);
+// eglGetProcAddress, for GL extensions glad does not load.
+void* getHeadlessProcAddress(const char* name);
+// Waits for the frame and writes the FBO to a binary PPM (P6) file.
+int  saveHeadlessFrame(const char* path);
+void closeHeadless();
+
+#endif
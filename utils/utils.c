@@ -8,6 +8,20 @@ SDL_Window* getSDLWindow() {
     return gWindow;
 }
 
+static int createWindow(const char* name, int width, int height, Uint32 flags) {
+    gWindow = SDL_CreateWindow(
+            name,
+            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+            width, height,
+            flags | SDL_WINDOW_RESIZABLE);
+    if (!gWindow) {
+        SDL_Log("Error creating window: %s", SDL_GetError());
+        SDL_Quit();
+        return -1;
+    }
+    return 0;
+}
+
 int initSDL(const char* name, int width, int height) {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         SDL_Log("SDL init video fail, %s", SDL_GetError());
@@ -18,17 +32,17 @@ int initSDL(const char* name, int width, int height) {
     SDL_GL_SetAttribute(
             SDL_GL_CONTEXT_PROFILE_MASK,
             SDL_GL_CONTEXT_PROFILE_CORE);
-    gWindow = SDL_CreateWindow(
-            name,
-            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-            width, height,
-            SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
-    if (!gWindow) {
-        SDL_Log("Error creating window: %s", SDL_GetError());
-        SDL_Quit();
+    // Full-resolution drawable on HiDPI displays (see SDL_GL_GetDrawableSize)
+    return createWindow(name, width, height, SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI);
+}
+
+// Plain window for the software rasterizer, presented through its surface
+int initSDLSoftware(const char* name, int width, int height) {
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        SDL_Log("SDL init video fail, %s", SDL_GetError());
         return -1;
     }
-    return 0;
+    return createWindow(name, width, height, 0);
 }
 
 int initGL() {
@@ -50,7 +64,7 @@ int initGL() {
         return -1;
     }
     int w, h;
-    SDL_GetWindowSize(gWindow, &w, &h);
+    SDL_GL_GetDrawableSize(gWindow, &w, &h);   // pixels, not window units
     glViewport(0, 0, w, h);
     return 0;
 }
@@ -5,6 +5,7 @@
 
 SDL_Window* getSDLWindow();
 int initSDL(const char* name, int width, int height);
+int initSDLSoftware(const char* name, int width, int height);
 int initGL();
 void blackScreen();
 void closeGL();